@@ -1,9 +1,16 @@
 #include <pebble.h>
 #include "assert.h"
+#include "log.h"
 #include "digit.h"
+#include "digit_set.h"
 #include "field.h"
 #include "settings.h"
 #include "bitmap.h"
+#include "date_font.h"
+#include "layout.h"
+#include "render.h"
+#include "wake.h"
+#include "sprite.h"
 
 
 // real const
@@ -11,9 +18,33 @@
 #define ANIMATION_SPACING_Y (TETRIMINO_MASK_SIZE + 1)
 #define MAX_TETRIMINO_AGE_STEPS 3
 #define MAX_TETRIMINO_AGE (MAX_TETRIMINO_AGE_STEPS * s_settings[CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES])
+STATIC_ASSERT(STATE_COUNT == LAYOUT_SLOT_COUNT);
+
+// pick a random precomputed drop order every time a digit is assembled
+#define DYNAMIC_ASSEMBLY 1
+
+// the random choices of the animation; target is what the choice is
+// measured against, -1 if nothing. Host tools define ANIMATION_CHOOSE
+// before including the watchface to steer them.
+typedef enum {
+    AC_ORDER,
+    // index into the spawn positions, target is the landing x
+    AC_SPAWN_X,
+    // rotations still to make after spawning
+    AC_ROTATION,
+} AnimationChoice;
+
+#ifndef ANIMATION_CHOOSE
+#define ANIMATION_CHOOSE(choice, count, target) (rand() % (count))
+#endif
+
+// animation frames compare and paint only the cells around tetriminos that
+// moved, instead of the whole field
+#define DELTA_RENDER 1
 
-// debug settings
-#define DYNAMIC_ASSEMBLY 0
+// scheduler settings
+#define MAX_FALLING_TETRIMINOS 6
+#define DIGIT_START_STAGGER_FRAMES 3
 
 typedef struct {
     int8_t offset_x;
@@ -30,44 +61,215 @@ typedef struct {
 
     int8_t action_height;
     int8_t vanishing_frame;
+    int8_t start_delay;
+
+    // transition plan: target starts with shared_count tetriminos that stay
+    // in place, keep_mask marks them in current while the rest vanishes
+    int8_t planned_value;
+    int8_t planned_offset_x;
+    int8_t shared_count;
+    uint16_t keep_mask;
 
     bool restricted_spawn_width;
 } DigitState;
 
 // time state
 static bool s_show_second_dot = true;
+// running while seconds are awake after a tap
+static AppTimer* s_seconds_timer;
+static bool s_seconds_ticking;
+static bool s_seconds_shown;
+static uint8_t s_second;
+// inside quiet hours digits change without animation and nothing ticks
+// faster than a minute
+static bool s_quiet;
 static uint8_t s_month;
 static uint8_t s_day;
 static uint8_t s_weekday;
 
-// color state
-static GColor s_bg_color;
-static GColor s_fg_color;
+// color state, as field colors
+static FieldColor s_bg_color;
+static FieldColor s_fg_color;
+#ifdef PBL_COLOR
+// fading from the tetrimino color to the foreground takes at most 3 steps per channel
+#define TETRIMINO_FADE_STEPS 4
+static FieldColor s_tetrimino_colors[TETRIMINO_COUNT][TETRIMINO_FADE_STEPS];
+#endif
+
+// status icons
+static const SpriteDef s_battery_charging_sprite = { &s_battery_charging_strip, 6, 4, 600 };
+static Sprite s_battery_sprite;
 
 // pebbele infrastructure
 static bool s_animating;
 static Window* s_window;
 static Layer* s_layer;
-static bool s_second_draw_hack;
 
 // digit states
 static DigitState s_states[STATE_COUNT];
 static int8_t s_date_frame;
 
+// the date is kept as glyph slots so a change animates only the glyphs that
+// differ; y is relative to the split between time and date
+#define DATE_SLOT_COUNT 12
+
+typedef struct {
+    const Bitmap* bmp;
+    int8_t x;
+    int8_t y;
+    uint8_t frame;
+} DateSlot;
+
+static DateSlot s_date_slots[DATE_SLOT_COUNT];
+static uint8_t s_date_slot_count;
+
+// what the screen shows of each tetrimino, kept so that a frame in which
+// only tetriminos moved repaints just the cells around the ones that changed
+typedef struct {
+    int8_t x;
+    int8_t y;
+    char letter;
+    uint8_t rotation;
+    FieldColor color;
+    bool drawn;
+} PieceRecord;
+
+static PieceRecord s_piece_records[STATE_COUNT][DIGIT_MAX_TETRIMINOS];
+
+// scheduler state
+static int s_spawn_budget;
+
+static int state_falling_tetriminos(const DigitState* state) {
+    if (!state->falling) {
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < state->current.size; ++i) {
+        if (memcmp(&state->current.tetriminos[i], &state->target.tetriminos[i], sizeof(TetriminoPos)) != 0) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+static void load_digit(DigitDef* dst, int value, int order) {
+    const TetriminoPos* tetriminos = digit_tetriminos(value);
+    const uint8_t* indices = digit_order(value, order);
+    dst->size = digit_size(value);
+    for (int i = 0; i < dst->size; ++i) {
+        dst->tetriminos[i] = tetriminos[indices[i]];
+    }
+}
+
+static void mark_columns(int8_t* deepest, const TetriminoPos* tp) {
+    const TetriminoMask* tm = &get_tetrimino_def(tp->letter)->rotations[tp->rotation];
+    for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+        for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+            const int x = tp->x + mask_x;
+            if ((*tm)[mask_y][mask_x] && x >= 0 && x < DIGIT_WIDTH && deepest[x] < tp->y + mask_y) {
+                deepest[x] = tp->y + mask_y;
+            }
+        }
+    }
+}
+
+static bool is_above(const int8_t* deepest, const TetriminoPos* tp) {
+    const TetriminoMask* tm = &get_tetrimino_def(tp->letter)->rotations[tp->rotation];
+    for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+        for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+            const int x = tp->x + mask_x;
+            if ((*tm)[mask_y][mask_x] && x >= 0 && x < DIGIT_WIDTH && deepest[x] > tp->y + mask_y) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Matches the landed tetriminos against the next digit. Those with the same
+// letter, rotation and screen position are kept, unless something that still
+// has to fall would land below them. The kept ones go first in target.
+static void state_plan_transition(DigitState* state) {
+    DigitDef next;
+    load_digit(&next, state->next_value, DYNAMIC_ASSEMBLY ? ANIMATION_CHOOSE(AC_ORDER, DIGIT_ORDER_COUNT, -1) : 0);
+
+    int8_t match[DIGIT_MAX_TETRIMINOS];
+    uint16_t used = 0;
+    for (int j = 0; j < next.size; ++j) {
+        const TetriminoPos* np = &next.tetriminos[j];
+        match[j] = -1;
+        for (int i = 0; i < state->current.size; ++i) {
+            const TetriminoPos* cp = &state->current.tetriminos[i];
+            if (!(used & (1 << i)) && cp->letter == np->letter && cp->rotation == np->rotation && cp->y == np->y &&
+                cp->x + state->offset_x == np->x + state->next_offset_x) {
+                match[j] = i;
+                used |= 1 << i;
+                break;
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        int8_t deepest[DIGIT_WIDTH];
+        memset(deepest, -1, sizeof(deepest));
+        for (int j = 0; j < next.size; ++j) {
+            if (match[j] < 0) {
+                mark_columns(deepest, &next.tetriminos[j]);
+            }
+        }
+        changed = false;
+        for (int j = 0; j < next.size; ++j) {
+            if (match[j] >= 0 && is_above(deepest, &next.tetriminos[j])) {
+                match[j] = -1;
+                changed = true;
+            }
+        }
+    }
+
+    state->target.size = 0;
+    state->keep_mask = 0;
+    for (int j = 0; j < next.size; ++j) {
+        if (match[j] >= 0) {
+            state->target.tetriminos[state->target.size++] = next.tetriminos[j];
+            state->keep_mask |= 1 << match[j];
+        }
+    }
+    state->shared_count = state->target.size;
+    for (int j = 0; j < next.size; ++j) {
+        if (match[j] < 0) {
+            state->target.tetriminos[state->target.size++] = next.tetriminos[j];
+        }
+    }
+    state->planned_value = state->next_value;
+    state->planned_offset_x = state->next_offset_x;
+}
+
 static void state_step(DigitState* state) {
     if (!state->falling) {
         if (state->next_value != state->target_value || state->next_offset_x != state->offset_x) {
+            if (state->start_delay) {
+                state->start_delay -= 1;
+                return;
+            }
+            if (state->planned_value != state->next_value || state->planned_offset_x != state->next_offset_x) {
+                state_plan_transition(state);
+            }
             const int animation_period_frames = s_settings[CUSTOM_ANIMATION_PERIOD_VIS_FRAMES] + s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES];
-            if (state->vanishing_frame > s_settings[CUSTOM_ANIMATION_PERIOD_COUNT] * animation_period_frames) {
+            // an empty digit still waits out the vanishing periods, so that
+            // the first drop on load and a leading digit appearing keep
+            // their pause
+            const bool nothing_vanishes = state->current.size && state->keep_mask == (1 << state->current.size) - 1;
+            if (nothing_vanishes || state->vanishing_frame > s_settings[CUSTOM_ANIMATION_PERIOD_COUNT] * animation_period_frames) {
                 //APP_LOG(APP_LOG_LEVEL_INFO, "Digit target changed to %d", state->next_value);
                 state->target_value = state->next_value;
                 state->offset_x = state->next_offset_x;
-                if (DYNAMIC_ASSEMBLY) {
-                    reorder_digit(&state->target, &s_digits[state->target_value]);
-                } else {
-                    state->target = s_digits[state->target_value];
+                state->current.size = state->shared_count;
+                for (int i = 0; i < state->shared_count; ++i) {
+                    state->current.tetriminos[i] = state->target.tetriminos[i];
+                    state->current_tetrimino_age[i] = MAX_TETRIMINO_AGE;
                 }
-                state->current.size = 0;
+                state->keep_mask = 0;
                 state->falling = true;
                 state->vanishing_frame = 0;
             } else {
@@ -115,7 +317,9 @@ static void state_step(DigitState* state) {
             }
         }
      
-        last_y = current_pos->y;
+        if (i >= state->shared_count) {
+            last_y = current_pos->y;
+        }
     }
     
     
@@ -125,18 +329,15 @@ static void state_step(DigitState* state) {
         const TetriminoDef* td = get_tetrimino_def(target_letter);
 
         const int start_y = -state->offset_y - td->size + 1;
-        if (last_y >= (start_y + ANIMATION_SPACING_Y)) {
+        if (s_spawn_budget > 0 && last_y >= (start_y + ANIMATION_SPACING_Y)) {
+            s_spawn_budget -= 1;
             TetriminoPos* current_pos = &state->current.tetriminos[state->current.size];
             current_pos->letter = target_letter;
-            if (state->restricted_spawn_width) {
-                const int spawn_width = 4;
-                current_pos->x = rand() % (spawn_width - td->size + 1);
-                current_pos->x += (DIGIT_WIDTH - spawn_width) / 2;
-            } else {
-                current_pos->x = rand() % (DIGIT_WIDTH - td->size + 1);
-            }
+            const int spawn_width = state->restricted_spawn_width ? 4 : DIGIT_WIDTH;
+            const int spawn_x = (DIGIT_WIDTH - spawn_width) / 2;
+            current_pos->x = spawn_x + ANIMATION_CHOOSE(AC_SPAWN_X, spawn_width - td->size + 1, target_pos->x - spawn_x);
             current_pos->y = start_y;
-            const int rotation_unique = rand() % td->unique_shapes;
+            const int rotation_unique = ANIMATION_CHOOSE(AC_ROTATION, td->unique_shapes, -1);
             current_pos->rotation = (target_pos->rotation - rotation_unique + 4) % 4;
             state->action_height = start_y;
             state->current_tetrimino_age[state->current.size] = 0;
@@ -156,19 +357,40 @@ static void state_step(DigitState* state) {
     }
 }
 
-static void draw_weekday_line(int height, GColor color) {
-  //date font switch gogo  
-  const Bitmap* weekdays = s_settings[CRO_DATE_FONT] ? s_cro_weekdays : s_small_weekdays;
-  //const Bitmap* weekdays = s_small_weekdays;
-    const Bitmap* bmp = &weekdays[s_weekday];
-    draw_bitmap(bmp, (FIELD_WIDTH - bmp->width + 1) / 2, height, color);
+// jumps to the end of the digit's transition without animating it
+static void state_finish(DigitState* state) {
+    if (!state->falling) {
+        // an empty vanishing phase makes the step plan and start the fall
+        const int animation_period_frames = s_settings[CUSTOM_ANIMATION_PERIOD_VIS_FRAMES] + s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES];
+        state->vanishing_frame = s_settings[CUSTOM_ANIMATION_PERIOD_COUNT] * animation_period_frames + 1;
+        state->start_delay = 0;
+        state_step(state);
+    }
+    state->current = state->target;
+    for (int j = 0; j < state->current.size; ++j) {
+        state->current_tetrimino_age[j] = MAX_TETRIMINO_AGE;
+    }
+    state->falling = false;
+    state->vanishing_frame = 0;
+    state->start_delay = 0;
 }
 
-static void draw_marked_weekday_line(int height, GColor color, bool use_letter) {
-  //marked weekdays font switch gogo
-    const Bitmap* marked_weekdays = s_settings[CRO_DATE_FONT] ? s_cro_marked_weekdays : s_small_marked_weekdays;
-  //const Bitmap* marked_weekdays = s_small_marked_weekdays;
-    
+static void add_date_slot(DateSlot* slots, int* count, int* xptr, const Bitmap* bmp, int y, int spacing) {
+    ASSERT(*count < DATE_SLOT_COUNT);
+    slots[*count] = (DateSlot) { .bmp = bmp, .x = *xptr, .y = y, .frame = 0 };
+    *count += 1;
+    *xptr += bmp->width + spacing;
+}
+
+static void layout_weekday_line(DateSlot* slots, int* count, int height) {
+    const Bitmap* bmp = &s_date_font.weekdays[s_weekday];
+    int offset = (FIELD_WIDTH - bmp->width + 1) / 2;
+    add_date_slot(slots, count, &offset, bmp, height, 0);
+}
+
+static void layout_marked_weekday_line(DateSlot* slots, int* count, int height, bool use_letter) {
+    const Bitmap* marked_weekdays = s_date_font.marked_weekdays;
+
     const int first_weekday = s_settings[DATE_FIRST_WEEKDAY];
     int width = 0;
     for (int i = 0; i < 7; ++i) {
@@ -180,19 +402,15 @@ static void draw_marked_weekday_line(int height, GColor color, bool use_letter)
     for (int i = 0; i < 7; ++i) {
         const int day = (first_weekday + i) % 7;
         const int bmp_idx = (day == s_weekday) ? (use_letter ? day : 8) : 7;
-        draw_bitmap_move(&offset, &marked_weekdays[bmp_idx], height, color, 0);
+        add_date_slot(slots, count, &offset, &marked_weekdays[bmp_idx], height, 0);
     }
 }
 
-static void draw_date_line(int height, GColor color) {
+static void layout_date_line(DateSlot* slots, int* count, int height) {
     const DateMonthFormat dmf = s_settings[DATE_MONTH_FORMAT];
-    //various font switch gogo
-    const Bitmap* months = s_settings[CRO_DATE_FONT] ? s_cro_months : s_small_months;
-    const Bitmap* weekdays = s_settings[CRO_DATE_FONT] ? s_cro_weekdays : s_small_weekdays;
-    int extra_height = s_settings[CRO_DATE_FONT] ? 1 : 0; //for croatian taller months (because of ž)
-    
-    //const Bitmap* months = s_small_months;
-    //const Bitmap* weekdays = s_small_weekdays;
+    const Bitmap* months = s_date_font.months;
+    const Bitmap* weekdays = s_date_font.weekdays;
+    const int extra_height = s_date_font.month_raise;
     const Bitmap* bmp_digits = s_bmp_small_digits;
     const int bmp_digit_width = BMP_SMALL_DIGIT_WIDTH;
   
@@ -223,22 +441,22 @@ static void draw_date_line(int height, GColor color) {
     
     // month before
     if (dmf == DMF_MONTH_BEFORE) {
-        draw_bitmap_move(&offset, &months[s_month], height-extra_height, color, date_word_spacing);
+        add_date_slot(slots, count, &offset, &months[s_month], height-extra_height, date_word_spacing);
     } else if (dmf == DMF_WEEKDAY_BEFORE) {
-        draw_bitmap_move(&offset, &weekdays[s_weekday], height, color, date_word_spacing);
+        add_date_slot(slots, count, &offset, &weekdays[s_weekday], height, date_word_spacing);
     }
 
     // date
     if (s_day >= 10) {
-        draw_bitmap_move(&offset, &bmp_digits[s_day / 10], height, color, 1);
+        add_date_slot(slots, count, &offset, &bmp_digits[s_day / 10], height, 1);
     }
-    draw_bitmap_move(&offset, &bmp_digits[s_day % 10], height, color, date_word_spacing);
+    add_date_slot(slots, count, &offset, &bmp_digits[s_day % 10], height, date_word_spacing);
 
     // month after
     if (dmf == DMF_MONTH_AFTER) {
-        draw_bitmap_move(&offset, &months[s_month], height-extra_height, color, date_word_spacing);
+        add_date_slot(slots, count, &offset, &months[s_month], height-extra_height, date_word_spacing);
     } else if (dmf == DMF_WEEKDAY_AFTER) {
-        draw_bitmap_move(&offset, &weekdays[s_weekday], height, color, date_word_spacing);
+        add_date_slot(slots, count, &offset, &weekdays[s_weekday], height, date_word_spacing);
     }
 }
 
@@ -246,6 +464,50 @@ static int get_final_date_split_height() {
     return s_states[0].offset_y + DIGIT_HEIGHT + s_settings[CUSTOM_TIME_DATE_SPACING_1];
 }
 
+// rebuilds the date slots; slots showing the same glyph at the same place
+// as before are kept as they are, the others grow in if animate is set
+static void date_update(bool animate) {
+    DateSlot slots[DATE_SLOT_COUNT];
+    int count = 0;
+
+    if (s_settings[DATE_MODE] != DM_NONE) {
+        const int first_line_height = s_settings[CUSTOM_TIME_DATE_SPACING_2];
+        const int second_line_height = first_line_height + BMP_SMALL_HEIGHT + s_settings[CUSTOM_DATE_LINE_SPACING];
+
+        layout_date_line(slots, &count, first_line_height);
+        switch (s_settings[DATE_WEEKDAY_FORMAT]) {
+        case DWF_MARKED:
+            layout_marked_weekday_line(slots, &count, second_line_height-1, 0);
+            break;
+        case DWF_LETTER:
+            layout_marked_weekday_line(slots, &count, second_line_height, 1);
+            break;
+        case DWF_TEXT:
+            layout_weekday_line(slots, &count, second_line_height);
+            break;
+        default:
+            break; // nothing
+        }
+    }
+
+    const int date_period_frames = s_settings[CUSTOM_ANIMATION_DATE_PERIOD_FRAMES];
+    for (int i = 0; i < count; ++i) {
+        DateSlot* slot = &slots[i];
+        if (animate) {
+            slot->frame = slot->bmp->height * date_period_frames;
+        }
+        for (int j = 0; j < s_date_slot_count; ++j) {
+            const DateSlot* old = &s_date_slots[j];
+            if (old->bmp == slot->bmp && old->x == slot->x && old->y == slot->y) {
+                slot->frame = animate ? old->frame : 0;
+                break;
+            }
+        }
+    }
+    memcpy(s_date_slots, slots, count * sizeof(DateSlot));
+    s_date_slot_count = count;
+}
+
 static void draw_date() {
     const DateMode dm = s_settings[DATE_MODE];
     if (dm == DM_NONE) {
@@ -255,36 +517,19 @@ static void draw_date() {
     const int date_period_frames = s_settings[CUSTOM_ANIMATION_DATE_PERIOD_FRAMES];
     const int split_height = get_final_date_split_height() + (s_date_frame + date_period_frames - 1) / date_period_frames;
 
-    GColor date_color;
+    FieldColor date_color;
     if (dm == DM_INVERTED) {
         date_color = s_bg_color;
-        for (int j = split_height; j < FIELD_HEIGHT; ++j) {
-            for (int i = 0; i < FIELD_WIDTH; ++i) {
-                field_draw(i, j, s_fg_color);
-            }
-        }
+        field_fill_rows(s_next_field, split_height, FIELD_HEIGHT, s_fg_color);
     } else {
         date_color = s_fg_color;
     }
 
-    const int bmp_height = BMP_SMALL_HEIGHT;
-    const int first_line_height = split_height + s_settings[CUSTOM_TIME_DATE_SPACING_2];
-    const int second_line_height = first_line_height + bmp_height + s_settings[CUSTOM_DATE_LINE_SPACING];
-    const DateWeekdayFormat dwf = s_settings[DATE_WEEKDAY_FORMAT];
-
-    draw_date_line(first_line_height, date_color);
-    switch(dwf) {
-    case DWF_MARKED:
-        draw_marked_weekday_line(second_line_height-1, date_color, 0);
-        break;
-    case DWF_LETTER:
-        draw_marked_weekday_line(second_line_height, date_color, 1);
-        break;
-    case DWF_TEXT:
-        draw_weekday_line(second_line_height, date_color);
-        break;
-    default:
-        break; // nothing
+    for (int i = 0; i < s_date_slot_count; ++i) {
+        const DateSlot* slot = &s_date_slots[i];
+        // a changed glyph grows upwards from its bottom row
+        const int hidden_rows = (slot->frame + date_period_frames - 1) / date_period_frames;
+        draw_bitmap_rows(slot->bmp, slot->x, split_height + slot->y, hidden_rows, date_color);
     }
 }
 
@@ -298,54 +543,67 @@ static inline int _step(int current, int target, int max_step) {
     return current;
 }
 
-static void draw_tetrimino(const TetriminoPos* tp, int offset_x, int offset_y, int age) {
-    const TetriminoDef* td = get_tetrimino_def(tp->letter); 
-    const TetriminoMask* tm = &td->rotations[tp->rotation];
-
-    GColor color = s_fg_color;
-    
+static FieldColor tetrimino_color(const TetriminoDef* td, int age) {
     #ifdef PBL_COLOR
     if (age < MAX_TETRIMINO_AGE) {
-        color = BYTE_TO_COLOR(td->color);
         const int age_step = age / s_settings[CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES];
-
-        if (age_step) {
-            color.r = _step(color.r, s_fg_color.r, age_step);
-            color.g = _step(color.g, s_fg_color.g, age_step);
-            color.b = _step(color.b, s_fg_color.b, age_step);
-        }
+        return s_tetrimino_colors[td - s_tetrimino_defs][_min(age_step, TETRIMINO_FADE_STEPS - 1)];
     }
     #endif
+    return s_fg_color;
+}
 
+static void draw_mask(const TetriminoMask* tm, int x, int y, FieldColor color) {
     for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
         for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
             if ((*tm)[mask_y][mask_x]) {
-                const int x = tp->x + mask_x + offset_x;
-                const int y = tp->y + mask_y + offset_y;
-                field_draw(x, y, color);
+                field_draw(x + mask_x, y + mask_y, color);
             }
         }
     }
 }
 
-static void draw_digit_def(const DigitDef* def, int offset_x, int offset_y, const int8_t* ages) {
-    for (int i = 0; i < def->size; ++i) {
-        draw_tetrimino(&def->tetriminos[i], offset_x, offset_y, ages[i]);
-    }
+// the colon is left out while the second dot is off, unless it animates
+static bool state_is_shown(int i) {
+    const DigitState* state = &s_states[i];
+    return i != 4 || s_show_second_dot || state->falling || state->vanishing_frame;
 }
 
-static void draw_digit_state(const DigitState* state) {
+// fills in what a state shows of each of its tetriminos in this frame
+static void state_records(const DigitState* state, bool shown, PieceRecord* records) {
+    bool blinked_out = false;
     if (state->vanishing_frame) {
         const int animation_period_frames = s_settings[CUSTOM_ANIMATION_PERIOD_VIS_FRAMES] + s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES];
         const int in_period = (state->vanishing_frame - 1) % animation_period_frames;
-        if (in_period < s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES]) {
-            return;
+        blinked_out = in_period < s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES];
+    }
+    memset(records, 0, DIGIT_MAX_TETRIMINOS * sizeof(PieceRecord));
+    for (int i = 0; shown && i < state->current.size; ++i) {
+        // tetriminos shared with the next digit don't blink
+        if (blinked_out && !(state->keep_mask & (1 << i))) {
+            continue;
+        }
+        const TetriminoPos* tp = &state->current.tetriminos[i];
+        PieceRecord* record = &records[i];
+        record->x = tp->x + state->offset_x;
+        record->y = tp->y + state->offset_y;
+        record->letter = tp->letter;
+        record->rotation = tp->rotation;
+        record->color = tetrimino_color(get_tetrimino_def(tp->letter), state->current_tetrimino_age[i]);
+        record->drawn = true;
+    }
+}
+
+static void draw_pieces(const PieceRecord* records) {
+    for (int i = 0; i < DIGIT_MAX_TETRIMINOS; ++i) {
+        const PieceRecord* record = &records[i];
+        if (record->drawn) {
+            draw_mask(&get_tetrimino_def(record->letter)->rotations[record->rotation], record->x, record->y, record->color);
         }
     }
-    draw_digit_def(&state->current, state->offset_x, state->offset_y, state->current_tetrimino_age);
 }
 
-static void draw_digit_state_directy(Layer* layer, GContext* ctx, const DigitState* state, GColor color) {
+static void draw_digit_state_directy(Layer* layer, GContext* ctx, const DigitState* state, FieldColor color) {
     for (int t = 0; t < state->current.size; ++t) {
         const TetriminoPos* tp = &state->current.tetriminos[t];
         const TetriminoDef* td = get_tetrimino_def(tp->letter);
@@ -362,40 +620,150 @@ static void draw_digit_state_directy(Layer* layer, GContext* ctx, const DigitSta
     }
 }
 
-static void layer_draw(Layer* layer, GContext* ctx) {
-    if (s_second_draw_hack) {
-        GColor second_color = s_show_second_dot ? s_fg_color : s_bg_color;
-        draw_digit_state_directy(layer, ctx, &s_states[4], second_color);
-        s_second_draw_hack = false;
+// icons are at most this many rows tall
+#define STATUS_ROWS 5
+
+// seconds readout sits between the icons on the status rows
+#define SECONDS_WIDTH (2 * BMP_SMALL_DIGIT_WIDTH + 1)
+#define SECONDS_X ((FIELD_WIDTH - SECONDS_WIDTH) / 2)
+
+static void draw_seconds() {
+    if (!s_seconds_shown) {
         return;
     }
-    for (int i = 0; i < 4; ++i) {
-        draw_digit_state(&s_states[i]);
+    int x = SECONDS_X;
+    draw_bitmap_move(&x, &s_bmp_small_digits[s_second / 10], FIELD_STATUS_Y, s_fg_color, 1);
+    draw_bitmap(&s_bmp_small_digits[s_second % 10], x, FIELD_STATUS_Y, s_fg_color);
+}
+
+// all battery icons are this wide
+#define BATTERY_WIDTH 6
+#define BATTERY_X (FIELD_ROW_END(FIELD_STATUS_Y) - BATTERY_WIDTH)
+
+static void draw_battery_icon() {
+    if (!s_settings[ICON_BATTERY]) {
+        return;
     }
-    if (s_show_second_dot || s_states[4].falling || s_states[4].vanishing_frame) {
-        draw_digit_state(&s_states[4]);
+    BatteryChargeState charge_state = battery_state_service_peek();
+    if (charge_state.is_charging) {
+        draw_sprite(&s_battery_sprite, BATTERY_X, FIELD_STATUS_Y, s_fg_color);
+    } else if (charge_state.charge_percent <= 10) {
+        draw_bitmap(&s_battery_empty, BATTERY_X, FIELD_STATUS_Y, s_fg_color);
+    } else if (charge_state.charge_percent <= 20) {
+        draw_bitmap(&s_battery_halfempty, BATTERY_X, FIELD_STATUS_Y, s_fg_color);
     }
-    draw_date();
+}
+
+static void draw_icons() {
     if (s_settings[ICON_CONNECTION]) {
         if (!bluetooth_connection_service_peek()) {
-            draw_bitmap(&s_bluetooth, 0, 0, s_fg_color);
+            draw_bitmap(&s_bluetooth, FIELD_ROW_BEGIN(FIELD_STATUS_Y), FIELD_STATUS_Y, s_fg_color);
         }
     }
-  //battery icon!
-    if (s_settings[ICON_BATTERY]) {
-        const Bitmap* bmp = NULL;
-        BatteryChargeState charge_state = battery_state_service_peek();
-        if (charge_state.is_charging) {
-            bmp = &s_battery_charging;
-        } else if (charge_state.charge_percent <= 10) {
-            bmp = &s_battery_empty;
-        } else if (charge_state.charge_percent <= 20) {
-            bmp = &s_battery_halfempty;
+    draw_battery_icon();
+}
+
+// the charging icon loops while charging, other than in quiet hours
+static void battery_update_sprite() {
+    const bool charging = s_settings[ICON_BATTERY] && battery_state_service_peek().is_charging;
+    sprite_set_running(&s_battery_sprite, charging && !s_quiet);
+}
+
+static void paint_status(Layer* layer, GContext* ctx, uint8_t reasons) {
+    if (reasons & RR_ICONS) {
+        field_paint_rect(layer, ctx, 0, FIELD_STATUS_Y, FIELD_WIDTH, STATUS_ROWS);
+        return;
+    }
+    if (reasons & RR_SECONDS) {
+        field_paint_rect(layer, ctx, SECONDS_X, FIELD_STATUS_Y, SECONDS_WIDTH, BMP_SMALL_HEIGHT);
+    }
+    if (reasons & RR_SPRITES) {
+        field_paint_rect(layer, ctx, BATTERY_X, FIELD_STATUS_Y, BATTERY_WIDTH, s_battery_charging_strip.height);
+    }
+}
+
+// The scene is drawn as usual, but only cells that can differ from the
+// screen are compared: the footprints of tetriminos whose record changed,
+// before and after, and the status regions asked for. Tetriminos pass over
+// the status row and fall next to each other, so neighbours come out right
+// only because everything was drawn.
+static void layer_draw_pieces(Layer* layer, GContext* ctx, uint8_t reasons) {
+    PieceRecord records[STATE_COUNT][DIGIT_MAX_TETRIMINOS];
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        state_records(&s_states[i], state_is_shown(i), records[i]);
+        draw_pieces(records[i]);
+    }
+    draw_date();
+    draw_icons();
+    draw_seconds();
+
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        for (int j = 0; j < DIGIT_MAX_TETRIMINOS; ++j) {
+            const PieceRecord* last = &s_piece_records[i][j];
+            const PieceRecord* next = &records[i][j];
+            if (memcmp(last, next, sizeof(PieceRecord)) == 0) {
+                continue;
+            }
+            // one rect around both footprints, they mostly overlap
+            const PieceRecord* a = last->drawn ? last : next;
+            const PieceRecord* b = next->drawn ? next : last;
+            const int x = _min(a->x, b->x);
+            const int y = _min(a->y, b->y);
+            field_paint_rect(layer, ctx, x, y, abs(a->x - b->x) + TETRIMINO_MASK_SIZE, abs(a->y - b->y) + TETRIMINO_MASK_SIZE);
+        }
+    }
+    paint_status(layer, ctx, reasons);
+    field_discard();
+    memcpy(s_piece_records, records, sizeof(records));
+}
+
+static void layer_draw(Layer* layer, GContext* ctx) {
+    const uint8_t reasons = render_take();
+#if DELTA_RENDER
+    if (s_field_inited && (reasons & RR_PIECES) && !(reasons & (RR_DIGITS | RR_DATE))) {
+        layer_draw_pieces(layer, ctx, reasons);
+        return;
+    }
+#endif
+    // without a painted field underneath there is nothing to patch
+    if (s_field_inited && !(reasons & (RR_DIGITS | RR_DATE | RR_PIECES))) {
+        if (reasons & RR_DOT) {
+            FieldColor second_color = s_show_second_dot ? s_fg_color : s_bg_color;
+            draw_digit_state_directy(layer, ctx, &s_states[4], second_color);
+            state_records(&s_states[4], state_is_shown(4), s_piece_records[4]);
+        }
+        // a large time offset moves the digits into the status rows, the
+        // flushes below would erase whatever of them is not drawn again
+        if (s_states[0].offset_y < FIELD_STATUS_Y + STATUS_ROWS) {
+            for (int i = 0; i < STATE_COUNT; ++i) {
+                draw_pieces(s_piece_records[i]);
+            }
+            draw_date();
+        }
+        if (reasons & RR_ICONS) {
+            draw_icons();
+            draw_seconds();
+            field_flush_rows(layer, ctx, FIELD_STATUS_Y, FIELD_STATUS_Y + STATUS_ROWS);
+            return;
         }
-        if (bmp) {
-            draw_bitmap(bmp, FIELD_WIDTH - bmp->width, 0, s_fg_color);
+        // only the cells of the glyphs that changed get painted
+        if (reasons & RR_SECONDS) {
+            draw_seconds();
+            field_flush_rect(layer, ctx, SECONDS_X, FIELD_STATUS_Y, SECONDS_WIDTH, BMP_SMALL_HEIGHT);
         }
+        if (reasons & RR_SPRITES) {
+            draw_battery_icon();
+            field_flush_rect(layer, ctx, BATTERY_X, FIELD_STATUS_Y, BATTERY_WIDTH, s_battery_charging_strip.height);
+        }
+        return;
     }
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        state_records(&s_states[i], state_is_shown(i), s_piece_records[i]);
+        draw_pieces(s_piece_records[i]);
+    }
+    draw_date();
+    draw_icons();
+    draw_seconds();
     
     field_flush(layer, ctx);
 }
@@ -404,34 +772,94 @@ static int is_animating() {
     if (s_date_frame) {
         return 1;
     }
+    for (int i = 0; i < s_date_slot_count; ++i) {
+        if (s_date_slots[i].frame) {
+            return 1;
+        }
+    }
     for (int i = 0; i < STATE_COUNT; ++i) {
-        if (s_states[i].falling || s_states[i].vanishing_frame) {
+        if (s_states[i].falling || s_states[i].vanishing_frame || s_states[i].start_delay) {
             return 1;
         }
     }
     return 0;
 }
 
+// steps all digits while keeping the number of simultaneously falling
+// tetriminos bounded, so per-frame cost stays flat when every digit changes
+// at once; digits to the left get spawn slots first
+static void schedule_step() {
+    int falling = 0;
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        falling += state_falling_tetriminos(&s_states[i]);
+    }
+    s_spawn_budget = MAX_FALLING_TETRIMINOS - falling;
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        state_step(&s_states[i]);
+    }
+}
+
+static void subscribe_ticks();
+static void seconds_update(int second);
+static void process_animation(void* data);
+static void animation_seconds(void* data);
+
+static void animation_schedule(bool frame_ran) {
+    const Wake wake = wake_next(s_settings[CUSTOM_ANIMATION_TIMEOUT_MS], frame_ran, s_seconds_ticking);
+    app_timer_register(wake.timeout_ms, wake.frame ? process_animation : animation_seconds, NULL);
+}
+
+// a second boundary between frames, drawn at once rather than with the
+// next frame. The colon and the status row may be mid animation, so this
+// goes through the piece path like a frame, which repaints them from their
+// records; the idle paths would paint the colon flat and leave stale cells.
+static void animation_seconds(void* data) {
+    const int second = wake_new_second();
+    if (second >= 0) {
+        seconds_update(second);
+    }
+    render_frame(RR_PIECES);
+    animation_schedule(false);
+}
+
 static void process_animation(void* data) {
-    /*
-    static int st = 0;
-    APP_LOG(APP_LOG_LEVEL_INFO, "Step %d", st);
-    st += 1;
-    */
-    
-    s_animating = true;
+    if (!s_animating) {
+        s_animating = true;
+        wake_begin();
+        // frames take over the seconds
+        if (s_seconds_ticking) {
+            subscribe_ticks();
+        }
+    } else if (s_seconds_ticking) {
+        const int second = wake_new_second();
+        if (second >= 0) {
+            seconds_update(second);
+        }
+    }
+
+    // date reveal is not throttled, it always advances alongside the digits
+    uint8_t reasons = RR_PIECES;
     if (s_date_frame) {
         s_date_frame -= 1;
+        reasons |= RR_DATE;
     }
-    for (int i = 0; i < STATE_COUNT; ++i) {
-        state_step(&s_states[i]);
+    for (int i = 0; i < s_date_slot_count; ++i) {
+        if (s_date_slots[i].frame) {
+            s_date_slots[i].frame -= 1;
+            reasons |= RR_DATE;
+        }
     }
-    layer_mark_dirty(s_layer);
+    schedule_step();
+    render_frame(reasons);
     if (is_animating()) {
-        app_timer_register(s_settings[CUSTOM_ANIMATION_TIMEOUT_MS], process_animation, NULL);
+        animation_schedule(true);
     } else {
         s_animating = false;
+        if (s_seconds_ticking) {
+            subscribe_ticks();
+        }
     }
+    render_set_frame_due(s_animating);
 }
 
 inline static void notify(NotificationType notification) {
@@ -451,8 +879,8 @@ inline static void notify(NotificationType notification) {
 }
 
 static void bt_handler(bool connected) {
-    if (s_layer && s_settings[ICON_CONNECTION]) {
-        layer_mark_dirty(s_layer);
+    if (s_settings[ICON_CONNECTION]) {
+        render_request(RR_ICONS);
     }
     if (connected) {
         notify(s_settings[NOTIFICATION_CONNECTED]);
@@ -461,17 +889,59 @@ static void bt_handler(bool connected) {
     }
 }
 
+static bool quiet_hours_contain(int hour) {
+    const int start = s_settings[QUIET_HOURS_START];
+    const int end = s_settings[QUIET_HOURS_END];
+    if (!s_settings[QUIET_HOURS] || start == end) {
+        return false;
+    }
+    return start < end ? (hour >= start && hour < end) : (hour >= start || hour < end);
+}
+
+// finishes whatever is still animating, the next change will not animate
+static void quiet_finish_animations() {
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        state_finish(&s_states[i]);
+    }
+    s_date_frame = 0;
+    for (int i = 0; i < s_date_slot_count; ++i) {
+        s_date_slots[i].frame = 0;
+    }
+    render_request(RR_DIGITS | RR_DATE);
+}
+
+// entering quiet hours only drops the seconds, a running animation finishes
+// at the next change; leaving them lets the next change animate again
+static void quiet_update(int hour) {
+    const bool quiet = quiet_hours_contain(hour);
+    if (quiet != s_quiet) {
+        s_quiet = quiet;
+        subscribe_ticks();
+        battery_update_sprite();
+    }
+}
+
 static void tick_handler(struct tm* tick_time, TimeUnits units_changed) {
+    if (units_changed & HOUR_UNIT) {
+        quiet_update(tick_time->tm_hour);
+    }
+
     if (units_changed & DAY_UNIT) {
         s_month = tick_time->tm_mon;
         s_day = tick_time->tm_mday;
         s_weekday = tick_time->tm_wday;
         //s_weekday = (tick_time->tm_sec / 2) % 7;
         //s_month = ((tick_time->tm_sec + 1) / 2) % 12;
+        date_update(units_changed != (TimeUnits)(-1) && !s_quiet);
+        if (s_quiet) {
+            render_request(RR_DATE);
+        } else if (!s_animating && is_animating()) {
+            process_animation(NULL);
+        }
     }
 
     if (units_changed & HOUR_UNIT) {
-        if (units_changed != (TimeUnits)(-1)) {
+        if (units_changed != (TimeUnits)(-1) && !s_quiet) {
             notify(s_settings[NOTIFICATION_HOURLY]);
         }
     }
@@ -496,220 +966,288 @@ static void tick_handler(struct tm* tick_time, TimeUnits units_changed) {
         digit_values[3] = tick_time->tm_min % 10;
         digit_values[4] = 10;
 
-   //     if (true) { //gogo !clock24
-            if (digit_values[0] == 0) {
-                digit_values[0] = DIGIT_COUNT;
-
-                digit_offsets[0] = 0;
-                digit_offsets[1] = 5;
-                digit_offsets[2] = 17;
-                digit_offsets[3] = 25;
-                digit_offsets[4] = 11;
-
-                /*
-                  if (digit_values[1] == 1) {
-                  for (int i = 0; i < STATE_COUNT; ++i) {
-                  s_states[i].next_offset_x -= 1;
-                  }
-                  }
-                */
-            } else {
-                digit_offsets[0] = 0;
-                digit_offsets[1] = 8;
-                digit_offsets[2] = 20;
-                digit_offsets[3] = 28;
-                digit_offsets[4] = 14;
-            }
-  /*      } else {
-            digit_offsets[0] = 2;
-            digit_offsets[1] = 10;
-            digit_offsets[2] = 20;
-            digit_offsets[3] = 28;
-            digit_offsets[4] = 15;
-        } */
-      //offset fix for digit 1, should be tinner gogo
-        if (digit_values[1]==1) {
-          digit_offsets[0]+=1;
-          digit_offsets[1]-=1;
-          digit_offsets[2]-=1;
-          digit_offsets[3]-=1;
-          digit_offsets[4]-=1;
-        }
-        
-        if (digit_values[2]==1) {
-          digit_offsets[0]+=1;
-          digit_offsets[1]+=1;
-          digit_offsets[2]-=1;
-          digit_offsets[3]-=1;
-          digit_offsets[4]+=1;
-        }
-      
-        if (digit_values[3]==1) {
-          digit_offsets[0]+=1;
-          digit_offsets[1]+=1;
-          digit_offsets[2]+=1;
-          digit_offsets[3]-=1;
-          digit_offsets[4]+=1;
-        }  
-        if (digit_values[0]==2) {
-          digit_offsets[0]+=1;
-          digit_offsets[1]+=1;
-          digit_offsets[2]+=1;
-          digit_offsets[3]+=1;
-          digit_offsets[4]+=1;
+        if (digit_values[0] == 0) {
+            digit_values[0] = DIGIT_COUNT;
+        }
+        const int8_t* layout = layout_offsets(s_settings[DIGITS_MODE], clock24, layout_key(digit_values));
+        const int layout_offset_x = (FIELD_WIDTH - LAYOUT_FIELD_WIDTH) / 2;
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            digit_offsets[i] = layout[i] + layout_offset_x;
         }
     
-        bool changed = false;
+        int changed = 0;
         for (int i = 0; i < STATE_COUNT; ++i) {
             const int value = digit_values[i];
             const int offset = digit_offsets[i];
             if (s_states[i].next_value != value || s_states[i].next_offset_x != offset) {
                 s_states[i].next_value = value;
                 s_states[i].next_offset_x = offset;
+                // stagger digits changing together, single digit changes start at once
+                if (!s_states[i].falling && !s_states[i].vanishing_frame) {
+                    s_states[i].start_delay = changed * DIGIT_START_STAGGER_FRAMES;
+                }
                 //APP_LOG(APP_LOG_LEVEL_INFO, "Digit %d scheduled to be %d", i, value);
-                changed = true;
+                changed += 1;
             }
         }
 
-        if (changed && !s_animating) {
+        if (changed && s_quiet) {
+            quiet_finish_animations();
+        } else if (changed && !s_animating) {
             process_animation(NULL);
         }
     }
 
-    if (units_changed & SECOND_UNIT) { //seconds gogo
-        if (s_settings[ANIMATE_SECOND_DOT]) {
-            s_show_second_dot = tick_time->tm_sec % 2;
-            s_second_draw_hack = !s_animating;
-            layer_mark_dirty(s_layer);
+    if ((units_changed & SECOND_UNIT) && s_seconds_ticking) {
+        seconds_update(tick_time->tm_sec);
+    }
+}
+
+static void seconds_update(int second) {
+    if (s_settings[ANIMATE_SECOND_DOT]) {
+        s_show_second_dot = second % 2;
+        render_request(RR_DOT);
+    }
+    if (s_settings[SHOW_SECONDS]) {
+        s_second = second;
+        render_request(RR_SECONDS);
+    }
+}
+
+static bool seconds_needed() {
+    return s_settings[ANIMATE_SECOND_DOT] || s_settings[SHOW_SECONDS];
+}
+
+// seconds are only needed while the colon blinks or the readout is on;
+// with a window set they run only for that long after the last tap. While
+// the digits animate the frames do the seconds, see wake.h.
+static void subscribe_ticks() {
+    tick_timer_service_unsubscribe();
+    const bool seconds = seconds_needed() && !s_quiet && (!s_settings[SECOND_DOT_WINDOW] || s_seconds_timer);
+    s_seconds_ticking = seconds;
+    if (s_seconds_shown != (seconds && s_settings[SHOW_SECONDS])) {
+        s_seconds_shown = !s_seconds_shown;
+        if (s_seconds_shown) {
+            time_t now = time(NULL);
+            s_second = localtime(&now)->tm_sec;
+        }
+        render_request(RR_SECONDS);
+    }
+    if (seconds && !s_animating) {
+        tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
+    } else {
+        if (!seconds && !s_show_second_dot) {
+            s_show_second_dot = true;
+            render_request(RR_DOT);
         }
+        tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+    }
+}
+
+static void seconds_timeout_handler(void* data) {
+    s_seconds_timer = NULL;
+    subscribe_ticks();
+}
+
+// taps include wrist flicks
+static void accel_tap_handler(AccelAxisType axis, int32_t direction) {
+    if (s_quiet) {
+        return;
+    }
+    const uint32_t timeout_ms = s_settings[SECOND_DOT_WINDOW] * 1000;
+    if (s_seconds_timer) {
+        app_timer_reschedule(s_seconds_timer, timeout_ms);
+    } else {
+        s_seconds_timer = app_timer_register(timeout_ms, seconds_timeout_handler, NULL);
+        subscribe_ticks();
     }
 }
 
 static void battery_handler(BatteryChargeState charge_state) {
-    if (s_layer) {
-        layer_mark_dirty(s_layer);
+    if (s_settings[ICON_BATTERY]) {
+        render_request(RR_ICONS);
     }
+    battery_update_sprite();
 }
 
-static void on_settings_changed() {
-    int offset_y = (FIELD_HEIGHT - DIGIT_HEIGHT) / 2;
-    if (s_settings[DATE_MODE] != DM_NONE) {
-        offset_y -= s_settings[CUSTOM_TIME_OFFSET];
+static void on_settings_changed(uint8_t changes) {
+    if (changes & SC_LAYOUT) {
+        int offset_y = (FIELD_HEIGHT - DIGIT_HEIGHT) / 2;
+        if (s_settings[DATE_MODE] != DM_NONE) {
+            offset_y -= s_settings[CUSTOM_TIME_OFFSET];
+        }
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            s_states[i].offset_y = offset_y;
+        }
+        render_request(RR_DIGITS | RR_DATE);
     }
-    for (int i = 0; i < STATE_COUNT; ++i) {
-        s_states[i].offset_y = offset_y;
+
+    if (changes & SC_COLORS) {
+        // background and foreground first, then the pure tetrimino colors, so
+        // that only fade steps can fall back to a nearby palette entry
+        field_palette_reset();
+        if (s_settings[LIGHT_THEME]) {
+            s_bg_color = field_palette_add(GColorWhite);
+            s_fg_color = field_palette_add(GColorBlack);
+        } else {
+            s_bg_color = field_palette_add(GColorBlack);
+            s_fg_color = field_palette_add(GColorWhite);
+        }
+        #ifdef PBL_COLOR
+        const GColor fg = field_resolve(s_fg_color);
+        for (int age_step = 0; age_step < TETRIMINO_FADE_STEPS; ++age_step) {
+            for (int t = 0; t < TETRIMINO_COUNT; ++t) {
+                GColor color = BYTE_TO_COLOR(s_tetrimino_defs[t].color);
+                color.r = _step(color.r, fg.r, age_step);
+                color.g = _step(color.g, fg.g, age_step);
+                color.b = _step(color.b, fg.b, age_step);
+                s_tetrimino_colors[t][age_step] = field_palette_add(color);
+            }
+        }
+        #endif
+        // painted cells hold indices into the old palette
+        field_reset(s_bg_color);
+        render_request(RR_ALL);
     }
 
-    if (s_settings[LIGHT_THEME]) {
-        s_bg_color = GColorWhite;
-        s_fg_color = GColorBlack;
-    } else {
-        s_bg_color = GColorBlack;
-        s_fg_color = GColorWhite;
+    if (changes & SC_ANIMATION) {
+        // landed tetriminos keep their final color under the new fade length
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            if (!s_states[i].falling) {
+                for (int j = 0; j < s_states[i].current.size; ++j) {
+                    s_states[i].current_tetrimino_age[j] = MAX_TETRIMINO_AGE;
+                }
+            }
+        }
+        render_request(RR_DIGITS);
     }
 
-    if (!s_settings[SKIP_INITIAL_ANIMATION]) {
-        s_date_frame = (FIELD_HEIGHT - get_final_date_split_height()) * s_settings[CUSTOM_ANIMATION_DATE_PERIOD_FRAMES];
-    } else {
-        s_date_frame = 0;
+    if (changes & SC_DATE) {
+        // glyphs of another language never match the slots shown
+        if (date_font_load(s_settings[DATE_LANGUAGE])) {
+            s_date_slot_count = 0;
+        }
+        date_update(true);
+        render_request(RR_DATE);
     }
 
-    tick_timer_service_unsubscribe();
-    if (s_settings[ANIMATE_SECOND_DOT]) {
-        tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
-    } else {
-        s_show_second_dot = true;
-        tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+    if (changes & SC_SECONDS) {
+        if (seconds_needed() && s_settings[SECOND_DOT_WINDOW]) {
+            accel_tap_service_subscribe(accel_tap_handler);
+        } else {
+            accel_tap_service_unsubscribe();
+            if (s_seconds_timer) {
+                app_timer_cancel(s_seconds_timer);
+                s_seconds_timer = NULL;
+            }
+        }
+        subscribe_ticks();
     }
 
-    if (s_settings[ICON_CONNECTION] || s_settings[NOTIFICATION_DISCONNECTED] || s_settings[NOTIFICATION_CONNECTED]) {
-        bluetooth_connection_service_subscribe(bt_handler);
-    } else {
-        bluetooth_connection_service_unsubscribe();
+    if (changes & SC_SERVICES) {
+        if (s_settings[ICON_CONNECTION] || s_settings[NOTIFICATION_DISCONNECTED] || s_settings[NOTIFICATION_CONNECTED]) {
+            bluetooth_connection_service_subscribe(bt_handler);
+        } else {
+            bluetooth_connection_service_unsubscribe();
+        }
+
+        if (s_settings[ICON_BATTERY]) {
+            battery_state_service_subscribe(battery_handler);
+        } else {
+            battery_state_service_unsubscribe();
+        }
     }
 
-    if (s_settings[ICON_BATTERY]) {
-        battery_state_service_subscribe(battery_handler);
-    } else {
-        battery_state_service_unsubscribe();
+    if (changes & SC_ICONS) {
+        battery_update_sprite();
+        render_request(RR_ICONS);
     }
 
-    field_reset(s_bg_color);
-    if (s_layer) {
-        layer_mark_dirty(s_layer);
+    if (changes & SC_QUIET) {
+        time_t now = time(NULL);
+        quiet_update(localtime(&now)->tm_hour);
     }
-    if (!s_animating) {
+
+    if (!s_animating && is_animating()) {
         process_animation(NULL);
     }
 }
 
 static void in_received_handler(DictionaryIterator* iter, void* context)
 {
+    if (dict_find(iter, LOG_DUMP_KEY)) {
+        log_dump();
+        return;
+    }
+
+    Settings old_settings;
+    memcpy(&old_settings, &s_settings, sizeof(Settings));
     settings_read(iter);
-    on_settings_changed();
+    const uint8_t changes = settings_get_changes(old_settings);
+    on_settings_changed(changes);
+
+    // digits mode changes the layout of the current time
+    if (changes & SC_LAYOUT) {
+        time_t now = time(NULL);
+        tick_handler(localtime(&now), MINUTE_UNIT);
+    }
 }
 
 static void main_window_load(Window* window) {
     s_layer = window_get_root_layer(window);
     layer_set_update_proc(s_layer, layer_draw);
+    render_attach(s_layer);
 
-    on_settings_changed();
+    on_settings_changed(SC_ALL);
 
     time_t now;
     time(&now);
     struct tm* now_time = localtime(&now);
     tick_handler(now_time, -1);
 
+    // only the first appearance reveals the whole date, later changes
+    // animate just the glyphs that differ; quiet hours already swapped in
+    // the time without animation
+    if (!s_settings[SKIP_INITIAL_ANIMATION] && !s_quiet) {
+        s_date_frame = (FIELD_HEIGHT - get_final_date_split_height()) * s_settings[CUSTOM_ANIMATION_DATE_PERIOD_FRAMES];
+    } else {
+        s_date_frame = 0;
+    }
+
     if (s_settings[SKIP_INITIAL_ANIMATION]) {
         for (int i = 0; i < STATE_COUNT; ++i) {
-            // skip vanishing animation
-            const int animation_period_frames = s_settings[CUSTOM_ANIMATION_PERIOD_VIS_FRAMES] + s_settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES];
-            s_states[i].vanishing_frame = s_settings[CUSTOM_ANIMATION_PERIOD_COUNT] * animation_period_frames + 1;
-            state_step(&s_states[i]);
-            s_states[i].current = s_states[i].target;
-            for (int j = 0; j < s_states[i].current.size; ++j) {
-                s_states[i].current_tetrimino_age[j] = MAX_TETRIMINO_AGE;
-            }
+            state_finish(&s_states[i]);
         }
     }
 }
 
 static void main_window_unload(Window* window) {
+    sprite_set_running(&s_battery_sprite, false);
     s_layer = NULL;
+    render_attach(NULL);
 }
   
 static void init() {
     srand(time(NULL));
 
     app_message_register_inbox_received(in_received_handler);
-    AppMessageResult rc = app_message_open(256, 256);
+    const uint32_t outbox_size = SETTINGS_MESSAGE_SIZE > LOG_DUMP_MESSAGE_SIZE ? SETTINGS_MESSAGE_SIZE : LOG_DUMP_MESSAGE_SIZE;
+    AppMessageResult rc = app_message_open(SETTINGS_MESSAGE_SIZE, outbox_size);
     ASSERT2(rc == APP_MSG_OK, "app_message_open => %d", (int)rc);
     
     settings_load_persistent();
-    
-#if USE_RAW_DIGITS == 1
-    bitmap_check_all();
-    for (int i = 0; i < DIGIT_COUNT; ++i) {
-        DigitDef def;
-        if (!parse_raw_digit(&def, &s_raw_digits[i])) {
-            return;
-        }
-        reorder_digit(&s_digits[i], &def);
-    }
-    /*
-    for (int i = 0; i < DIGIT_COUNT; ++i) {
-        format_digit_def_struct(&s_digits[i]);
-    }
-    */
-#endif
+    digit_set_load(RESOURCE_ID_DIGITS_DEFAULT);
 
     for (int i = 0; i < STATE_COUNT; ++i) {
         s_states[i].next_value = -1;
         s_states[i].target_value = -1;
+        s_states[i].planned_value = -1;
         // it looks better WITH vanishing animation
         //s_states[i].vanishing_frame = s_settings[CUSTOM_ANIMATION_PERIOD_COUNT] * ANIMATION_PERIOD_FRAMES + 1;
     }
     s_states[4].restricted_spawn_width = true;
+    sprite_init(&s_battery_sprite, &s_battery_charging_sprite);
+    field_init_visibility();
     
     // init window
     s_window = window_create();
@@ -721,10 +1259,13 @@ static void init() {
 static void deinit() {
     window_destroy(s_window);
     s_window = NULL;
+    digit_set_unload();
+    date_font_unload();
 }
 
 int main(void) {
     init();
     app_event_loop();
     deinit();
+    return 0;
 }
@@ -1,4 +1,7 @@
+// release builds turn asserts off with -DUSE_ASSERTS=0
+#ifndef USE_ASSERTS
 #define USE_ASSERTS 1
+#endif
 
 #if USE_ASSERTS == 1
 
@@ -10,8 +13,8 @@
 
 #else
 
-static inline _nop() {}
-#define ASSERT2(condition, message, ...) _nop()
+// the condition is not evaluated, but what it uses still counts as used
+#define ASSERT2(condition, message, ...) ((void)sizeof(condition))
 
 #endif
 
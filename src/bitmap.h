@@ -11,218 +11,6 @@ typedef struct {
     char* data;
 } Bitmap;
 
-static const Bitmap s_small_months[] = {
-    {
-        10, BMP_SMALL_HEIGHT,
-        " #        "
-        " #  ##  ##"
-        " # # # # #"
-        " # ### # #"
-        "#  # # # #"
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        "###    #  "
-        "#   ## #  "
-        "## ##  ## "
-        "#  #   # #"
-        "#   ## ## "
-    },
-    {
-        13, BMP_SMALL_HEIGHT,
-        "#   #        "
-        "## ##  ## ## "
-        "# # # # # # #"
-        "#   # ### ## "
-        "#   # # # # #"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        " ##        "
-        "# # ##  ## "
-        "### # # # #"
-        "# # ##  ## "
-        "# # #   # #"
-    },
-    {
-        13, BMP_SMALL_HEIGHT,
-        "#   #        "
-        "## ##  ## # #"
-        "# # # # # # #"
-        "#   # ###  # "
-        "#   # # # #  "
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        " #        "
-        " # # #  ##"
-        " # # # # #"
-        " # # # # #"
-        "#   ## # #"
-    },
-    {
-        9, BMP_SMALL_HEIGHT,
-        " #       "
-        " # # # # "
-        " # # # # "
-        " # # # # "
-        "#   ## ##"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        " ##        "
-        "# # # #  ##"
-        "### # # #  "
-        "# # # # # #"
-        "# #  ##  ##"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        " ##        "
-        "#    ## ## "
-        " #  ##  # #"
-        "  # #   ## "
-        "##   ## #  "
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        " ##     # "
-        "# #  ## ##"
-        "# # #   # "
-        "# # #   # "
-        "###  ##  #"
-    },
-    {
-        12, BMP_SMALL_HEIGHT,
-        "#  #        "
-        "#  #  ## # #"
-        "## # # # # #"
-        "# ## # # # #"
-        "#  # ##   # "
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        "##         "
-        "# #  ##  ##"
-        "# # ##  #  "
-        "# # #   #  "
-        "##   ##  ##"
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_small_months) == 12);
-
-static const Bitmap s_cro_months[] = {
-    {
-        8, BMP_LARGE_HEIGHT,
-        "    #  #"
-        " ##     "
-        "#   #  #"
-        " #  #  #"
-        "  # #  #"
-        "##  # # "
-    },
-    {
-        9, BMP_LARGE_HEIGHT,
-        "        #"
-        "# #      "
-        "# # #   #"
-        "# # #   #"
-        "# # #   #"
-        " #  ## # "
-    },
-    {
-        10, BMP_LARGE_HEIGHT,
-        "    ##    "
-        " ##       "
-        "# # ## # #"
-        "# #  # # #"
-        "# # #  # #"
-        "### ##  ##"
-    },
-    {
-        11, BMP_LARGE_HEIGHT,
-        "           "
-        "###        "
-        " #  ##   ##"
-        " #  # # # #"
-        " #  ##  ###"
-        " #  # # # #"
-    },
-    {
-        9, BMP_LARGE_HEIGHT,
-        "        #"
-        " ##      "
-        "#   # # #"
-        " #  # # #"
-        "  # # # #"
-        "##   #  #"
-    },
-    {
-        8, BMP_LARGE_HEIGHT,
-        "   #    "
-        "#       "
-        "#  # ## "
-        "#  # # #"
-        "#  # ## "
-        "## # #  "
-    },
-    {
-        11, BMP_LARGE_HEIGHT,
-        "           "
-        " ##        "
-        "#   ##  ## "
-        " #  # # # #"
-        "  # ##  ## "
-        "##  # # #  "
-    },
-    {
-        10, BMP_LARGE_HEIGHT,
-        "          "
-        "# #       "
-        "# #  ## # "
-        "##  # # # "
-        "# # # # # "
-        "# # ##  ##"
-    },
-    {
-        10, BMP_LARGE_HEIGHT,
-        "         #"
-        "##        "
-        "# # # #  #"
-        "##  # #  #"
-        "# # # #  #"
-        "# #  ## # "
-    },
-    {
-        7, BMP_LARGE_HEIGHT,
-        "   #   "
-        "#      "
-        "#  #  #"
-        "#  # # "
-        "#  #  #"
-        "## # # "
-    },
-    {
-        11, BMP_LARGE_HEIGHT,
-        "           "
-        " ##  #     "
-        "#   ### # #"
-        " #   #  # #"
-        "  #  #  # #"
-        "##   #   ##"
-    },
-    {
-        11, BMP_LARGE_HEIGHT,
-        "           "
-        "##         "
-        "# # ##   ##"
-        "##  # # # #"
-        "#   ##  # #"
-        "#   # # ## "
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_cro_months) == 12);
-
 static const Bitmap s_bmp_small_digits[] = {
     {
         BMP_SMALL_DIGIT_WIDTH, BMP_SMALL_HEIGHT,
@@ -307,260 +95,6 @@ static const Bitmap s_bmp_small_digits[] = {
 };
 STATIC_ASSERT(ARRAY_SIZE(s_bmp_small_digits) == 10);
 
-static const Bitmap s_small_marked_weekdays[] = {
-    { 5, 5,
-      " ### "
-      " #   "
-      " ### "
-      "   # "
-      " ### "
-    },
-    { 7, 5,
-      " #   # "
-      " ## ## "
-      " # # # "
-      " #   # "
-      " #   # "
-    },
-    { 5, 5,
-      " ### "
-      "  #  "
-      "  #  "
-      "  #  "
-      "  #  "
-    },
-    { 7, 5,
-      " #   # "
-      " #   # "
-      " #   # "
-      " # # # "
-      " ## ## "
-    },
-    { 5, 5,
-      " ### "
-      "  #  "
-      "  #  "
-      "  #  "
-      "  #  "
-    },
-    { 5, 5,
-      " ### "
-      " #   "
-      " ##  "
-      " #   "
-      " #   "
-    },
-    { 5, 5,
-      " ### "
-      " #   "
-      " ### "
-      "   # "
-      " ### "
-    },
-    { 4, 5,
-      "    "
-      "    "
-      " ## "
-      " ## "
-      "    "
-    },
-    { 6, 5,
-      "      "
-      " #### "
-      " #  # "
-      " #  # "
-      " #### "
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_small_marked_weekdays) == 9);
-
-static const Bitmap s_cro_marked_weekdays[] = {
-    { 6, 5,
-      " #  # "
-      " ## # "
-      " # ## "
-      " #  # "
-      " #  # "
-    },
-    { 5, 5,
-      " ### "
-      " # # "
-      " ### "
-      " #   "
-      " #   "
-    },
-    { 5, 5,
-      " # # "
-      " # # "
-      " # # "
-      " # # "
-      " ### "
-    },
-    { 5, 5,
-      " ### "
-      " #   "
-      " ### "
-      "   # "
-      " ### "
-    },
-    { 5, 5,
-      "  ## "
-      " ### "
-      " #   "
-      " #   "
-      " ### "
-    },
-    { 5, 5,
-      " ### "
-      " # # "
-      " ### "
-      " #   "
-      " #   "
-    },
-    { 5, 5,
-      " ### "
-      " #   "
-      " ### "
-      "   # "
-      " ### "
-    },
-    { 4, 5,
-      "    "
-      "    "
-      " ## "
-      " ## "
-      "    "
-    },
-    { 6, 5,
-      "      "
-      " #### "
-      " #  # "
-      " #  # "
-      " #### "
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_cro_marked_weekdays) == 9);
-
-static const Bitmap s_small_weekdays[] = {
-    {
-        11, BMP_SMALL_HEIGHT,
-        " ##        "
-        "#   # #  ##"
-        " #  # # # #"
-        "  # # # # #"
-        "##   ## # #"
-    },
-    {
-        13, BMP_SMALL_HEIGHT,
-        "#   #        "
-        "## ##  ##  ##"
-        "# # # # # # #"
-        "#   # # # # #"
-        "#   # ##  # #"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        "###        "
-        " #  # #  ##"
-        " #  # # ## "
-        " #  # # #  "
-        " #   ##  ##"
-    },
-    {
-        13, BMP_SMALL_HEIGHT,
-        "#   #       #"
-        "#   #  ##   #"
-        "#   # ##   ##"
-        "# # # #   # #"
-        "## ##  ##  ##"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        "### #      "
-        " #  #   # #"
-        " #  ##  # #"
-        " #  # # # #"
-        " #  # #  ##"
-    },
-    {
-        9, BMP_SMALL_HEIGHT,
-        "###     #"
-        "#   ##   "
-        "##  # # #"
-        "#   ##  #"
-        "#   # # #"
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        " ##     # "
-        "#    ## ##"
-        " #  # # # "
-        "  # ### # "
-        "##  # #  #"
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_small_weekdays) == 7);
-
-static const Bitmap s_cro_weekdays[] = {
-    {
-        12, BMP_SMALL_HEIGHT,
-        "#  #       #"
-        "#  #  ##   #"
-        "## # ##   ##"
-        "# ## #   # #"
-        "#  #  ##  ##"
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        "##        "
-        "# # ##  ##"
-        "## # # # #"
-        "#  # # # #"
-        "#  ##  # #"
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        "# # #     "
-        "# # ##  ##"
-        "# # #  # #"
-        "# # #  # #"
-        " ##  # ## "
-    },
-    {
-        9, BMP_SMALL_HEIGHT,
-        " ##     #"
-        "#   ##   "
-        " #  # # #"
-        "  # ##  #"
-        "##  # # #"
-    },
-    {
-        10, BMP_SMALL_HEIGHT,
-        " ##     # "
-        " ##  ## ##"
-        "#   ##  # "
-        "#   #   # "
-        " ##  ##  #"
-    },
-    {
-        9, BMP_SMALL_HEIGHT,
-        "##     # "
-        "# # ## ##"
-        "## ##  # "
-        "#  #   # "
-        "#   ##  #"
-    },
-    {
-        11, BMP_SMALL_HEIGHT,
-        " ##     #  "
-        "#   # # #  "
-        " #  # # ## "
-        "  # # # # #"
-        "##   ## ## "
-    },
-};
-STATIC_ASSERT(ARRAY_SIZE(s_cro_weekdays) == 7);
-
 static const Bitmap s_bluetooth = {
     4, 5,
     "  # "
@@ -586,18 +120,21 @@ static const Bitmap s_battery_empty = {
     "####  "
 };
 
-static const Bitmap s_battery_charging = {
-    6, 4,
-    "      "
-    "####  "
-    "##### "
-    "####  "
+// charging battery filling up, four frames of 6x4 side by side; the last
+// one is shown when it does not move
+static const Bitmap s_battery_charging_strip = {
+    24, 4,
+    "                        "
+    "####  ####  ####  ####  "
+    "#   # ##  # ### # ##### "
+    "####  ####  ####  ####  "
 };
 
 
-static void draw_bitmap(const Bitmap* bmp, int x, int y, GColor color) {
-    int yoffset = 0;
-    for (int j = 0; j < bmp->height; ++j) {
+// draws the bitmap without its first row_begin rows
+static void draw_bitmap_rows(const Bitmap* bmp, int x, int y, int row_begin, FieldColor color) {
+    int yoffset = row_begin * bmp->width;
+    for (int j = row_begin; j < bmp->height; ++j) {
         for (int i = 0; i < bmp->width; ++i) {
             if (bmp->data[yoffset + i] != ' ') {
                 field_draw(x+i, y+j, color);
@@ -607,31 +144,29 @@ static void draw_bitmap(const Bitmap* bmp, int x, int y, GColor color) {
     }
 }
 
-static void draw_bitmap_move(int* xptr, const Bitmap* bmp, int y, GColor color, int spacing) {
+static void draw_bitmap(const Bitmap* bmp, int x, int y, FieldColor color) {
+    draw_bitmap_rows(bmp, x, y, 0, color);
+}
+
+static void draw_bitmap_move(int* xptr, const Bitmap* bmp, int y, FieldColor color, int spacing) {
     draw_bitmap(bmp, *xptr, y, color);
     *xptr += bmp->width + spacing;
 }
 
 static void bitmap_check(const Bitmap* bmp, const char* label) {
     if ((int)strlen(bmp->data) != bmp->width * bmp->height) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Bitmap %s size mismatch: %dx%d with data lenght %d", label, bmp->width, bmp->height, strlen(bmp->data));
+        LOG(BITMAP, LOG_ERROR, "Bitmap size mismatch: %dx%d with data lenght %d in %s", bmp->width, bmp->height, (int)strlen(bmp->data), label);
     }
 }
 
 #define BITMAP_CHECK_ARRAY(array) for (unsigned int i = 0; i < ARRAY_SIZE(array); ++i) { bitmap_check(&array[i], #array); }
 
 static void bitmap_check_all() {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Bitmap check");
-    BITMAP_CHECK_ARRAY(s_small_months);
-    BITMAP_CHECK_ARRAY(s_cro_months);
+    LOG(BITMAP, LOG_INFO, "Bitmap check");
     BITMAP_CHECK_ARRAY(s_bmp_small_digits);
-    BITMAP_CHECK_ARRAY(s_small_marked_weekdays);
-    BITMAP_CHECK_ARRAY(s_cro_marked_weekdays);
-    BITMAP_CHECK_ARRAY(s_small_weekdays);
-    BITMAP_CHECK_ARRAY(s_cro_weekdays);
     bitmap_check(&s_bluetooth, "bt");
     bitmap_check(&s_battery_empty, "bat_emp");
     bitmap_check(&s_battery_halfempty, "bat_hlfemp");
-    bitmap_check(&s_battery_charging, "bat_char");
-    APP_LOG(APP_LOG_LEVEL_INFO, "Bitmap done");
+    bitmap_check(&s_battery_charging_strip, "bat_char");
+    LOG(BITMAP, LOG_INFO, "Bitmap done");
 }
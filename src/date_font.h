@@ -0,0 +1,73 @@
+// Date glyphs come in one raw resource per language, written by
+// tools/gen_date_fonts.py, and only the selected language is loaded.
+// Glyph bitmaps point into the loaded resource; languages are the
+// DateLanguage values of settings.h.
+//
+// Layout, all single bytes: month raise, then width and height of every
+// glyph, then their pixels row by row, ' ' for empty. Glyphs are the 12
+// months, the 9 marked weekday glyphs and the 7 weekdays, in that order.
+
+#define DATE_FONT_MONTHS 12
+// Sunday to Saturday letters, then the unmarked and the marked day box
+#define DATE_FONT_MARKED_WEEKDAYS 9
+#define DATE_FONT_WEEKDAYS 7
+#define DATE_FONT_GLYPHS (DATE_FONT_MONTHS + DATE_FONT_MARKED_WEEKDAYS + DATE_FONT_WEEKDAYS)
+
+typedef struct {
+    uint8_t* data;
+    int8_t language;
+    // rows months sit above the line, for languages with taller months
+    uint8_t month_raise;
+    Bitmap months[DATE_FONT_MONTHS];
+    Bitmap marked_weekdays[DATE_FONT_MARKED_WEEKDAYS];
+    Bitmap weekdays[DATE_FONT_WEEKDAYS];
+} DateFont;
+
+static DateFont s_date_font = { .language = -1 };
+
+static uint32_t date_font_resource(int language) {
+    switch (language) {
+    case DL_CROATIAN:
+        return RESOURCE_ID_DATES_HR;
+    default:
+        return RESOURCE_ID_DATES_EN;
+    }
+}
+
+static void date_font_unload() {
+    free(s_date_font.data);
+    s_date_font.data = NULL;
+    s_date_font.language = -1;
+}
+
+// returns whether the glyphs changed
+static bool date_font_load(int language) {
+    if (language == s_date_font.language) {
+        return false;
+    }
+    date_font_unload();
+    const ResHandle handle = resource_get_handle(date_font_resource(language));
+    const size_t size = resource_size(handle);
+    uint8_t* data = malloc(size);
+    ASSERT(data && size > 1 + 2 * DATE_FONT_GLYPHS);
+    resource_load(handle, data, size);
+
+    Bitmap* const sections[] = { s_date_font.months, s_date_font.marked_weekdays, s_date_font.weekdays };
+    const int section_sizes[] = { DATE_FONT_MONTHS, DATE_FONT_MARKED_WEEKDAYS, DATE_FONT_WEEKDAYS };
+    const uint8_t* sizes = &data[1];
+    size_t offset = 1 + 2 * DATE_FONT_GLYPHS;
+    for (int section = 0; section < 3; ++section) {
+        for (int i = 0; i < section_sizes[section]; ++i) {
+            Bitmap* glyph = &sections[section][i];
+            glyph->width = *sizes++;
+            glyph->height = *sizes++;
+            glyph->data = (char*)&data[offset];
+            offset += glyph->width * glyph->height;
+        }
+    }
+    ASSERT(offset == size);
+    s_date_font.data = data;
+    s_date_font.language = language;
+    s_date_font.month_raise = data[0];
+    return true;
+}
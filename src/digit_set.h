@@ -0,0 +1,63 @@
+// Digit sets are raw resources written by tools/digitc.c, so a set costs
+// app RAM only while it is the one in use. The loaded set is kept exactly
+// as stored, with pointers to where each value starts.
+//
+// Layout, all single bytes: value count, order count, the size of each
+// value, then the tetriminos of each value as letter, rotation, x, y, then
+// the drop orders of each value as indices into its tetriminos. The blank
+// digit is a value of size 0.
+
+#define DIGIT_SET_VALUE_COUNT (DIGIT_COUNT + 1)
+#define DIGIT_SET_HEADER_SIZE (2 + DIGIT_SET_VALUE_COUNT)
+STATIC_ASSERT(sizeof(TetriminoPos) == 4);
+
+typedef struct {
+    uint8_t* data;
+    const TetriminoPos* tetriminos[DIGIT_SET_VALUE_COUNT];
+    const uint8_t* orders[DIGIT_SET_VALUE_COUNT];
+} DigitSet;
+
+static DigitSet s_digit_set;
+
+static void digit_set_unload() {
+    free(s_digit_set.data);
+    memset(&s_digit_set, 0, sizeof(s_digit_set));
+}
+
+static void digit_set_load(uint32_t resource_id) {
+    digit_set_unload();
+    const ResHandle handle = resource_get_handle(resource_id);
+    const size_t size = resource_size(handle);
+    uint8_t* data = malloc(size);
+    ASSERT(data && size >= DIGIT_SET_HEADER_SIZE);
+    resource_load(handle, data, size);
+    ASSERT(data[0] == DIGIT_SET_VALUE_COUNT && data[1] == DIGIT_ORDER_COUNT);
+
+    const uint8_t* sizes = &data[2];
+    size_t offset = DIGIT_SET_HEADER_SIZE;
+    for (int value = 0; value < DIGIT_SET_VALUE_COUNT; ++value) {
+        ASSERT(sizes[value] <= DIGIT_MAX_TETRIMINOS);
+        s_digit_set.tetriminos[value] = (const TetriminoPos*)&data[offset];
+        offset += sizes[value] * sizeof(TetriminoPos);
+    }
+    for (int value = 0; value < DIGIT_SET_VALUE_COUNT; ++value) {
+        s_digit_set.orders[value] = &data[offset];
+        offset += sizes[value] * DIGIT_ORDER_COUNT;
+    }
+    ASSERT(offset == size);
+    s_digit_set.data = data;
+}
+
+static inline int digit_size(int value) {
+    return s_digit_set.data[2 + value];
+}
+
+static inline const TetriminoPos* digit_tetriminos(int value) {
+    return s_digit_set.tetriminos[value];
+}
+
+// drop order as indices into the tetriminos of the value, the first order
+// is the fastest
+static inline const uint8_t* digit_order(int value, int order) {
+    return s_digit_set.orders[value] + order * digit_size(value);
+}
@@ -1,29 +1,223 @@
-#define FIELD_WIDTH 36
-#define FIELD_HEIGHT 42
 #define FIELD_CELL_SIZE 3
 #define FIELD_CELL_SPACING 1
+#define FIELD_CELL_PITCH (FIELD_CELL_SIZE + FIELD_CELL_SPACING)
+
+#ifdef PBL_ROUND
+#define FIELD_SCREEN_WIDTH 180
+#define FIELD_SCREEN_HEIGHT 180
+#define FIELD_OFFSET_X 0
+#define FIELD_OFFSET_Y 0
+// status icons are moved down to where the circle is wide enough
+#define FIELD_STATUS_Y 8
+#else
+#define FIELD_SCREEN_WIDTH 144
+#define FIELD_SCREEN_HEIGHT 168
 #define FIELD_OFFSET_X 0
 #define FIELD_OFFSET_Y 1
+#define FIELD_STATUS_Y 0
+#endif
+
+// last cell needs no trailing spacing
+#define FIELD_WIDTH ((FIELD_SCREEN_WIDTH - FIELD_OFFSET_X + FIELD_CELL_SPACING) / FIELD_CELL_PITCH)
+#define FIELD_HEIGHT ((FIELD_SCREEN_HEIGHT - FIELD_OFFSET_Y + FIELD_CELL_SPACING) / FIELD_CELL_PITCH)
+
+#ifdef PBL_COLOR
+// cells hold 4-bit indices into a palette built from the current settings,
+// two cells per byte
+#define FIELD_PALETTE_SIZE 16
+#define FIELD_ROW_SIZE ((FIELD_WIDTH + 1) / 2)
+typedef uint8_t FieldColor;
+typedef uint8_t FieldStorage;
+
+static GColor s_field_palette[FIELD_PALETTE_SIZE];
+static uint8_t s_field_palette_size;
+#else
+#define FIELD_ROW_SIZE FIELD_WIDTH
+typedef GColor FieldColor;
+typedef GColor FieldStorage;
+#endif
 
 static bool s_field_inited;
-static GColor s_field_bg_color;
-static GColor s_last_field[FIELD_HEIGHT][FIELD_WIDTH];
-static GColor s_next_field[FIELD_HEIGHT][FIELD_WIDTH];
+static FieldColor s_field_bg_color;
+static FieldStorage s_last_field[FIELD_HEIGHT][FIELD_ROW_SIZE];
+static FieldStorage s_next_field[FIELD_HEIGHT][FIELD_ROW_SIZE];
 
-static void field_reset(GColor background) {
-    s_field_bg_color = background;
+#ifdef PBL_COLOR
+static void field_palette_reset() {
+    s_field_palette_size = 0;
+}
+
+static inline int _color_distance(GColor a, GColor b) {
+    return abs(a.r - b.r) + abs(a.g - b.g) + abs(a.b - b.b);
+}
+
+// returns the index of color, adding it if needed; once the palette is full
+// the closest existing entry is used instead
+static FieldColor field_palette_add(GColor color) {
+    int best = 0;
+    for (int i = 0; i < s_field_palette_size; ++i) {
+        if (gcolor_equal(s_field_palette[i], color)) {
+            return i;
+        }
+        if (_color_distance(s_field_palette[i], color) < _color_distance(s_field_palette[best], color)) {
+            best = i;
+        }
+    }
+    if (s_field_palette_size < FIELD_PALETTE_SIZE) {
+        s_field_palette[s_field_palette_size] = color;
+        return s_field_palette_size++;
+    }
+    return best;
+}
+
+static inline GColor field_resolve(FieldColor color) {
+    return s_field_palette[color];
+}
+
+static inline bool field_color_equal(FieldColor a, FieldColor b) {
+    return a == b;
+}
+
+static inline FieldColor field_get(const FieldStorage* row, int x) {
+    return (row[x >> 1] >> ((x & 1) * 4)) & 0xF;
+}
+
+static inline void field_set(FieldStorage* row, int x, FieldColor color) {
+    const int shift = (x & 1) * 4;
+    row[x >> 1] = (row[x >> 1] & ~(0xF << shift)) | (color << shift);
+}
+
+// fills cells [begin, end) of a row: odd edges by nibble, the rest by byte
+static inline void field_fill_span(FieldStorage* row, int begin, int end, FieldColor color) {
+    if (begin >= end) {
+        return;
+    }
+    if (begin & 1) {
+        field_set(row, begin++, color);
+    }
+    if ((end & 1) && begin < end) {
+        field_set(row, --end, color);
+    }
+    if (begin < end) {
+        memset(&row[begin >> 1], color * 0x11, (end - begin) >> 1);
+    }
+}
+
+static inline void field_fill_storage(FieldStorage* cells, int count, FieldColor color) {
+    memset(cells, color * 0x11, count);
+}
+#else
+static void field_palette_reset() {}
+
+static inline FieldColor field_palette_add(GColor color) {
+    return color;
+}
+
+static inline GColor field_resolve(FieldColor color) {
+    return color;
+}
+
+static inline bool field_color_equal(FieldColor a, FieldColor b) {
+    return gcolor_equal(a, b);
+}
+
+static inline FieldColor field_get(const FieldStorage* row, int x) {
+    return row[x];
+}
+
+static inline void field_set(FieldStorage* row, int x, FieldColor color) {
+    row[x] = color;
+}
+
+static inline void field_fill_storage(FieldStorage* cells, int count, FieldColor color) {
+    if (sizeof(FieldStorage) == 1) {
+        memset(cells, *(const uint8_t*)&color, count);
+    } else {
+        for (int i = 0; i < count; ++i) {
+            cells[i] = color;
+        }
+    }
+}
+
+static inline void field_fill_span(FieldStorage* row, int begin, int end, FieldColor color) {
+    if (begin < end) {
+        field_fill_storage(&row[begin], end - begin, color);
+    }
+}
+#endif
+
+#ifdef PBL_ROUND
+// visible cells of each row form a single span [begin, end) on a round display
+static int8_t s_field_row_begin[FIELD_HEIGHT];
+static int8_t s_field_row_end[FIELD_HEIGHT];
+
+// keeps every cell with at least one pixel inside the display circle,
+// all math is done in half-pixels to stay in integers
+static void field_init_visibility() {
+    const int radius = FIELD_SCREEN_WIDTH;
     for (int j = 0; j < FIELD_HEIGHT; ++j) {
+        const int cy = 2 * (FIELD_OFFSET_Y + j * FIELD_CELL_PITCH) + FIELD_CELL_SIZE - FIELD_SCREEN_HEIGHT;
+        const int dy = abs(cy) > FIELD_CELL_SIZE ? abs(cy) - FIELD_CELL_SIZE : 0;
+        s_field_row_begin[j] = FIELD_WIDTH;
+        s_field_row_end[j] = 0;
         for (int i = 0; i < FIELD_WIDTH; ++i) {
-            s_last_field[j][i] = background;
-            s_next_field[j][i] = background;
+            const int cx = 2 * (FIELD_OFFSET_X + i * FIELD_CELL_PITCH) + FIELD_CELL_SIZE - FIELD_SCREEN_WIDTH;
+            const int dx = abs(cx) > FIELD_CELL_SIZE ? abs(cx) - FIELD_CELL_SIZE : 0;
+            if (dx * dx + dy * dy < radius * radius) {
+                if (i < s_field_row_begin[j]) {
+                    s_field_row_begin[j] = i;
+                }
+                s_field_row_end[j] = i + 1;
+            }
         }
     }
+}
+
+#define FIELD_ROW_BEGIN(y) (s_field_row_begin[y])
+#define FIELD_ROW_END(y) (s_field_row_end[y])
+#else
+static void field_init_visibility() {}
+
+#define FIELD_ROW_BEGIN(y) 0
+#define FIELD_ROW_END(y) FIELD_WIDTH
+#endif
+
+static inline bool field_is_visible(int x, int y) {
+    return y >= 0 && y < FIELD_HEIGHT && x >= FIELD_ROW_BEGIN(y) && x < FIELD_ROW_END(y);
+}
+
+// rows are contiguous, so whole rows are filled in one go
+static void field_fill_rows(FieldStorage (*field)[FIELD_ROW_SIZE], int y_begin, int y_end, FieldColor color) {
+    if (y_begin < 0) {
+        y_begin = 0;
+    }
+    if (y_end > FIELD_HEIGHT) {
+        y_end = FIELD_HEIGHT;
+    }
+    if (y_begin < y_end) {
+        field_fill_storage(field[y_begin], (y_end - y_begin) * FIELD_ROW_SIZE, color);
+    }
+}
+
+static void field_fill_rect(int x, int y, int w, int h, FieldColor color) {
+    const int y_end = (y + h < FIELD_HEIGHT) ? y + h : FIELD_HEIGHT;
+    for (int j = (y > 0 ? y : 0); j < y_end; ++j) {
+        const int begin = (x > FIELD_ROW_BEGIN(j)) ? x : FIELD_ROW_BEGIN(j);
+        const int end = (x + w < FIELD_ROW_END(j)) ? x + w : FIELD_ROW_END(j);
+        field_fill_span(s_next_field[j], begin, end, color);
+    }
+}
+
+static void field_reset(FieldColor background) {
+    s_field_bg_color = background;
+    field_fill_rows(s_last_field, 0, FIELD_HEIGHT, background);
+    field_fill_rows(s_next_field, 0, FIELD_HEIGHT, background);
     s_field_inited = false;
 }
 
-static void field_draw(int x, int y, GColor color) {
-    if (x >= 0 && y >= 0 && x < FIELD_WIDTH && y < FIELD_HEIGHT) {
-        s_next_field[y][x] = color;
+static void field_draw(int x, int y, FieldColor color) {
+    if (field_is_visible(x, y)) {
+        field_set(s_next_field[y], x, color);
     }
 }
 
@@ -73,23 +267,27 @@ static void log_field_state() {
 }
 */
 
-static void field_direct_draw(Layer* layer, GContext* ctx, int x, int y, GColor color) {
+static void field_direct_draw(Layer* layer, GContext* ctx, int x, int y, FieldColor color) {
+    if (!field_is_visible(x, y)) {
+        return;
+    }
     GRect rect;
     rect.size.h = FIELD_CELL_SIZE;
     rect.size.w = FIELD_CELL_SIZE;
-    rect.origin.x = FIELD_OFFSET_X + x * (FIELD_CELL_SIZE + FIELD_CELL_SPACING);
-    rect.origin.y = FIELD_OFFSET_Y + y * (FIELD_CELL_SIZE + FIELD_CELL_SPACING);
-    graphics_context_set_fill_color(ctx, color);
+    rect.origin.x = FIELD_OFFSET_X + x * FIELD_CELL_PITCH;
+    rect.origin.y = FIELD_OFFSET_Y + y * FIELD_CELL_PITCH;
+    graphics_context_set_fill_color(ctx, field_resolve(color));
     graphics_fill_rect(ctx, rect, 0, GCornerNone);
-    s_last_field[y][x] = color;
+    field_set(s_last_field[y], x, color);
 }
 
-static void field_flush(Layer* layer, GContext* ctx) {
+// paints the changed cells inside the rect
+static void _field_paint_rect(Layer* layer, GContext* ctx, int x, int y, int w, int h) {
     GRect rect;
     
     if (!s_field_inited) {
         rect = layer_get_bounds(layer);
-        graphics_context_set_fill_color(ctx, s_field_bg_color);
+        graphics_context_set_fill_color(ctx, field_resolve(s_field_bg_color));
         graphics_fill_rect(ctx, rect, 0, GCornerNone);
         s_field_inited = true;
     }
@@ -97,20 +295,58 @@ static void field_flush(Layer* layer, GContext* ctx) {
     rect.size.h = FIELD_CELL_SIZE;
     rect.size.w = FIELD_CELL_SIZE;
     
-    for (int j = 0; j < FIELD_HEIGHT; ++j) {
-        for (int i = 0; i < FIELD_WIDTH; ++i) {
-            const GColor next = s_next_field[j][i];
-            if (!gcolor_equal(next, s_last_field[j][i])) {
-                s_last_field[j][i] = next;
+    const int y_end = (y + h < FIELD_HEIGHT) ? y + h : FIELD_HEIGHT;
+    for (int j = (y > 0 ? y : 0); j < y_end; ++j) {
+        FieldStorage* next_row = s_next_field[j];
+        FieldStorage* last_row = s_last_field[j];
+        const int x_end = (x + w < FIELD_ROW_END(j)) ? x + w : FIELD_ROW_END(j);
+        for (int i = (x > FIELD_ROW_BEGIN(j)) ? x : FIELD_ROW_BEGIN(j); i < x_end; ++i) {
+#ifdef PBL_COLOR
+            // unchanged byte means two unchanged cells
+            if (!(i & 1) && next_row[i >> 1] == last_row[i >> 1]) {
+                i += 1;
+                continue;
+            }
+#endif
+            const FieldColor next = field_get(next_row, i);
+            if (!field_color_equal(next, field_get(last_row, i))) {
+                field_set(last_row, i, next);
                 
-                graphics_context_set_fill_color(ctx, next);
-                rect.origin.x = FIELD_OFFSET_X + i * (FIELD_CELL_SIZE + FIELD_CELL_SPACING);
-                rect.origin.y = FIELD_OFFSET_Y + j * (FIELD_CELL_SIZE + FIELD_CELL_SPACING);
+                graphics_context_set_fill_color(ctx, field_resolve(next));
+                rect.origin.x = FIELD_OFFSET_X + i * FIELD_CELL_PITCH;
+                rect.origin.y = FIELD_OFFSET_Y + j * FIELD_CELL_PITCH;
                 graphics_fill_rect(ctx, rect, 0, GCornerNone);
             }
-            s_next_field[j][i] = s_field_bg_color;
         }
     }
+}
+
+// paints the changed cells inside the rect and clears them for the next
+// frame; cells outside keep their pending state
+static void field_flush_rect(Layer* layer, GContext* ctx, int x, int y, int w, int h) {
+    _field_paint_rect(layer, ctx, x, y, w, h);
+    field_fill_rect(x, y, w, h, s_field_bg_color);
+}
+
+// paints the changed cells inside the rect and keeps the pending state, so
+// that overlapping rects can be painted one after another
+static void field_paint_rect(Layer* layer, GContext* ctx, int x, int y, int w, int h) {
+    _field_paint_rect(layer, ctx, x, y, w, h);
+}
+
+// drops the pending state without painting, for a frame whose painted
+// rects cover every cell that changed
+static void field_discard() {
+    field_fill_rows(s_next_field, 0, FIELD_HEIGHT, s_field_bg_color);
+}
+
+static void field_flush_rows(Layer* layer, GContext* ctx, int y_begin, int y_end) {
+    field_flush_rect(layer, ctx, 0, y_begin, FIELD_WIDTH, y_end - y_begin);
+}
+
+static void field_flush(Layer* layer, GContext* ctx) {
+    _field_paint_rect(layer, ctx, 0, 0, FIELD_WIDTH, FIELD_HEIGHT);
+    field_fill_rows(s_next_field, 0, FIELD_HEIGHT, s_field_bg_color);
 
     //log_field_state();
 }
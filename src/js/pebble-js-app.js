@@ -11,25 +11,54 @@ Pebble.addEventListener("ready",
     }
 );
 
+// the watch keeps its recent log records in a ring, see src/log.h
+var LOG_SUBSYSTEMS = ["app", "settings", "bitmap"];
+var LOG_LEVELS = ["none", "error", "info", "debug"];
+var LOG_RECORD_SIZE = 12;
+
+function print_log_dump(bytes) {
+    var read = function(offset, size) {
+        var value = 0;
+        for (var i = size - 1; i >= 0; --i) {
+            value = (value << 8) | bytes[offset + i];
+        }
+        return value;
+    };
+    console.log("Watch log, " + bytes.length / LOG_RECORD_SIZE + " records:");
+    for (var offset = 0; offset + LOG_RECORD_SIZE <= bytes.length; offset += LOG_RECORD_SIZE) {
+        var time = new Date((read(offset, 4) >>> 0) * 1000);
+        console.log(time.toISOString() + " " + LOG_LEVELS[bytes[offset + 7]] + " " +
+                    LOG_SUBSYSTEMS[bytes[offset + 6]] + ":" + read(offset + 4, 2) + " " + read(offset + 8, 4));
+    }
+}
+
 Pebble.addEventListener("appmessage",
     function(e) {
+        if ("LOG_DUMP" in e.payload) {
+            print_log_dump(e.payload.LOG_DUMP);
+            return;
+        }
         console.log("Got settings: " + JSON.stringify(e.payload));
         window.localStorage.options = JSON.stringify(e.payload);
     }
 );
 
+// BEGIN generated from app/configuration.html by tools/gen_config_page.py
+var CONFIG_PAGE = "<!DOCTYPE html>\n<html>\n  <!-- I'm obviously not a web programmer =/ -->\n  <head>\n    <title>Configuration<\/title>\n    <meta charset=\"utf-8\">\n    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\n    <style>\n      body { font-family: Helvetica, Arial, sans-serif; margin: 0; background: #f6f6f6; color: #222; }\n      h2 { text-align: center; }\n      h3 { margin: 0; font-size: 1em; }\n      fieldset { border: 1px solid #ccc; border-radius: 6px; background: #fff; margin: 0 0 10px 0; padding: 8px; }\n      legend { padding: 0 4px; }\n      label { display: inline-block; padding: 6px 0; }\n      fieldset label { margin-right: 12px; }\n      input[type=text] { width: 4em; font-size: 1em; }\n      .controls { overflow: hidden; }\n      button { font-size: 1.1em; padding: 10px 24px; margin: 10px; border-radius: 6px; border: 1px solid #888; }\n      #save { float: left; background: #333; color: #fff; }\n      #cancel { float: right; background: #eee; }\n      .preview { text-align: center; }\n      .preview canvas { image-rendering: pixelated; image-rendering: crisp-edges; margin: 4px auto; display: block; }\n      .preview .round { border-radius: 50%; }\n      .preview select { font-size: 1em; margin: 2px; }\n      #preview_stats { font-size: 0.9em; margin: 4px 0; }\n    <\/style>\n    <script type=\"text/javascript\">\n      // BEGIN generated by tools/preview_data.c\n      var PREVIEW_DATA = {\n        constants: {CELL_SIZE: 3, CELL_SPACING: 1, DIGIT_WIDTH: 6, DIGIT_HEIGHT: 10, DIGIT_COUNT: 11, DIGIT_ORDER_COUNT: 4, TETRIMINO_MASK_SIZE: 4, STATE_COUNT: 5, ANIMATION_SPACING_Y: 5, MAX_TETRIMINO_AGE_STEPS: 3, TETRIMINO_FADE_STEPS: 4, MAX_FALLING_TETRIMINOS: 6, DIGIT_START_STAGGER_FRAMES: 3, BMP_SMALL_HEIGHT: 5, BMP_SMALL_DIGIT_WIDTH: 3, LAYOUT_FIELD_WIDTH: 36, WAKE_ALIGN_MS: 50},\n        defaults: {LIGHT_THEME: 0, ANIMATE_SECOND_DOT: 0, DIGITS_MODE: 0, DATE_MODE: 1, DATE_MONTH_FORMAT: 0, DATE_WEEKDAY_FORMAT: 2, DATE_FIRST_WEEKDAY: 1, ICON_CONNECTION: 0, ICON_BATTERY: 0, NOTIFICATION_DISCONNECTED: 3, NOTIFICATION_CONNECTED: 3, SKIP_INITIAL_ANIMATION: 0, NOTIFICATION_HOURLY: 0, DATE_LANGUAGE: 0, CUSTOM_DATE: 0, CUSTOM_TIME_OFFSET: 0, CUSTOM_TIME_DATE_SPACING_1: 0, CUSTOM_TIME_DATE_SPACING_2: 0, CUSTOM_DATE_WORD_SPACING: 0, CUSTOM_DATE_LINE_SPACING: 0, CUSTOM_ANIMATIONS: 0, CUSTOM_ANIMATION_TIMEOUT_MS: 0, CUSTOM_ANIMATION_PERIOD_VIS_FRAMES: 0, CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES: 0, CUSTOM_ANIMATION_PERIOD_COUNT: 0, CUSTOM_ANIMATION_DATE_PERIOD_FRAMES: 0, CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES: 0, SECOND_DOT_WINDOW: 0, SHOW_SECONDS: 0, QUIET_HOURS: 0, QUIET_HOURS_START: 23, QUIET_HOURS_END: 7},\n        tetriminos: {\n          i: {size: 4, unique: 2, color: 207, rotations: [\"    ####        \", \"  #   #   #   # \", \"        ####    \", \" #   #   #   #  \"]},\n          j: {size: 3, unique: 4, color: 199, rotations: [\"#   ###         \", \" ##  #   #      \", \"    ###   #     \", \" #   #  ##      \"]},\n          l: {size: 3, unique: 4, color: 248, rotations: [\"  # ###         \", \" #   #   ##     \", \"    ### #       \", \"##   #   #      \"]},\n          o: {size: 2, unique: 1, color: 232, rotations: [\"##  ##          \", \"##  ##          \", \"##  ##          \", \"##  ##          \"]},\n          s: {size: 3, unique: 2, color: 204, rotations: [\" ## ##          \", \" #   ##   #     \", \"     ## ##      \", \"#   ##   #      \"]},\n          t: {size: 3, unique: 4, color: 226, rotations: [\" #  ###         \", \" #   ##  #      \", \"    ###  #      \", \" #  ##   #      \"]},\n          z: {size: 3, unique: 2, color: 240, rotations: [\"##   ##         \", \"  #  ##  #      \", \"    ##   ##     \", \" #  ##  #       \"]}\n        },\n        digits: [\n          [[\"j\", 3, 4, 7], [\"s\", 0, 2, 8], [\"t\", 1, 0, 7], [\"i\", 1, -2, 6], [\"z\", 1, 3, 5], [\"s\", 1, -1, 4], [\"t\", 1, 3, 3], [\"t\", 3, 0, 2], [\"s\", 1, 3, 1], [\"t\", 1, -1, 0], [\"z\", 0, 1, 0], [\"j\", 2, 3, -1]],\n          [[\"l\", 1, 3, 7], [\"l\", 3, 4, 6], [\"o\", 0, 4, 4], [\"i\", 0, 2, 2], [\"l\", 0, 2, 1], [\"l\", 3, 4, 0]],\n          [[\"j\", 0, 0, 8], [\"l\", 0, 3, 8], [\"i\", 0, 1, 7], [\"o\", 0, 0, 6], [\"i\", 0, 1, 4], [\"l\", 2, 0, 3], [\"j\", 2, 3, 3], [\"o\", 0, 4, 2], [\"i\", 0, 1, 0], [\"j\", 2, 3, -1], [\"l\", 2, 0, -1]],\n          [[\"o\", 0, 0, 8], [\"j\", 0, 2, 8], [\"j\", 3, 3, 6], [\"i\", 1, 3, 6], [\"i\", 0, 2, 4], [\"l\", 0, 2, 3], [\"l\", 3, 4, 2], [\"i\", 0, 1, 0], [\"j\", 2, 3, -1], [\"l\", 2, 0, -1]],\n          [[\"j\", 3, 4, 7], [\"j\", 1, 3, 6], [\"i\", 0, 1, 4], [\"l\", 2, 0, 3], [\"j\", 2, 3, 3], [\"o\", 0, 0, 2], [\"l\", 1, 3, 1], [\"l\", 3, 4, 0], [\"o\", 0, 0, 0]],\n          [[\"j\", 0, 0, 8], [\"l\", 0, 3, 8], [\"i\", 0, 1, 7], [\"o\", 0, 4, 6], [\"i\", 0, 1, 4], [\"l\", 2, 0, 3], [\"j\", 2, 3, 3], [\"o\", 0, 0, 2], [\"i\", 0, 1, 0], [\"j\", 2, 3, -1], [\"l\", 2, 0, -1]],\n          [[\"j\", 0, 0, 8], [\"t\", 0, 3, 8], [\"j\", 0, 1, 7], [\"s\", 1, 3, 6], [\"t\", 1, -1, 5], [\"t\", 3, 4, 4], [\"s\", 0, 2, 4], [\"t\", 2, 0, 3], [\"o\", 0, 0, 2], [\"i\", 0, 1, 0], [\"j\", 2, 3, -1], [\"l\", 2, 0, -1]],\n          [[\"j\", 3, 4, 7], [\"j\", 1, 3, 6], [\"l\", 1, 3, 3], [\"l\", 3, 4, 2], [\"i\", 0, 1, 0], [\"j\", 2, 3, -1], [\"l\", 2, 0, -1]],\n          [[\"t\", 0, 1, 8], [\"z\", 0, 3, 8], [\"z\", 1, -1, 7], [\"t\", 3, 4, 6], [\"t\", 1, -1, 5], [\"j\", 0, 1, 4], [\"z\", 1, 3, 4], [\"l\", 0, 2, 3], [\"t\", 1, -1, 2], [\"t\", 3, 4, 1], [\"s\", 1, -1, 0], [\"s\", 0, 3, 0], [\"t\", 2, 1, -1]],\n          [[\"l\", 1, 3, 7], [\"j\", 0, 0, 8], [\"j\", 2, 1, 7], [\"l\", 3, 4, 6], [\"i\", 0, 2, 4], [\"s\", 0, 0, 4], [\"l\", 0, 3, 3], [\"z\", 1, -1, 2], [\"t\", 1, 3, 1], [\"t\", 1, -1, 0], [\"z\", 0, 1, 0], [\"j\", 2, 3, -1]],\n          [[\"o\", 0, 2, 6], [\"o\", 0, 2, 2]],\n          []\n        ],\n        orders: [\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11], [0, 3, 1, 2, 5, 4, 6, 7, 9, 10, 8, 11], [0, 1, 2, 4, 6, 8, 3, 5, 7, 9, 10, 11], [0, 1, 2, 3, 5, 7, 4, 6, 8, 9, 10, 11]],\n          [[0, 1, 2, 3, 4, 5], [0, 1, 2, 3, 4, 5], [0, 1, 2, 3, 4, 5], [0, 1, 2, 3, 4, 5]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10], [1, 0, 2, 3, 4, 5, 6, 7, 8, 10, 9], [1, 0, 2, 3, 4, 6, 7, 5, 8, 10, 9], [0, 1, 2, 3, 4, 6, 7, 5, 8, 10, 9]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9], [0, 3, 1, 2, 4, 5, 6, 7, 8, 9], [0, 1, 3, 2, 4, 5, 6, 7, 8, 9], [0, 3, 1, 2, 4, 5, 6, 7, 9, 8]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8], [0, 1, 2, 4, 6, 3, 7, 5, 8], [0, 1, 2, 3, 4, 5, 8, 6, 7], [0, 1, 2, 4, 3, 5, 8, 6, 7]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10], [0, 1, 2, 3, 4, 6, 5, 7, 8, 9, 10], [0, 1, 2, 3, 4, 6, 5, 7, 8, 10, 9], [1, 0, 2, 3, 4, 6, 5, 7, 8, 10, 9]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11], [1, 0, 2, 4, 3, 5, 6, 7, 8, 9, 10, 11], [0, 1, 3, 5, 2, 6, 4, 7, 8, 9, 10, 11], [1, 0, 3, 5, 2, 6, 4, 7, 8, 9, 11, 10]],\n          [[0, 1, 2, 3, 4, 5, 6], [0, 1, 2, 3, 4, 6, 5], [0, 1, 2, 3, 4, 5, 6], [0, 1, 2, 3, 4, 6, 5]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12], [0, 2, 4, 1, 3, 5, 6, 8, 10, 7, 9, 11, 12], [0, 2, 1, 3, 4, 6, 5, 8, 10, 7, 9, 11, 12], [0, 2, 4, 1, 3, 6, 5, 7, 8, 10, 9, 11, 12]],\n          [[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11], [1, 0, 2, 3, 4, 6, 8, 5, 7, 9, 10, 11], [1, 2, 0, 3, 4, 6, 8, 5, 7, 9, 10, 11], [1, 0, 2, 3, 4, 6, 5, 7, 9, 10, 8, 11]],\n          [[0, 1], [0, 1], [0, 1], [0, 1]],\n          [[], [], [], []]\n        ],\n        layouts: [\n          [[[0, 5, 17, 25, 11], [1, 6, 18, 24, 12], [1, 6, 16, 24, 12], [2, 7, 17, 23, 13], [1, 4, 16, 24, 10], [2, 5, 17, 23, 11], [2, 5, 15, 23, 11], [3, 6, 16, 22, 12], [0, 8, 20, 28, 14], [1, 9, 21, 27, 15], [1, 9, 19, 27, 15], [2, 10, 20, 26, 16], [1, 7, 19, 27, 13], [2, 8, 20, 26, 14], [2, 8, 18, 26, 14], [3, 9, 19, 25, 15], [1, 9, 21, 29, 15], [2, 10, 22, 28, 16], [2, 10, 20, 28, 16], [3, 11, 21, 27, 17], [2, 8, 20, 28, 14], [3, 9, 21, 27, 15], [3, 9, 19, 27, 15], [4, 10, 20, 26, 16]], [[0, 5, 17, 25, 11], [1, 6, 18, 24, 12], [1, 6, 16, 24, 12], [2, 7, 17, 23, 13], [1, 4, 16, 24, 10], [2, 5, 17, 23, 11], [2, 5, 15, 23, 11], [3, 6, 16, 22, 12], [0, 8, 20, 28, 14], [1, 9, 21, 27, 15], [1, 9, 19, 27, 15], [2, 10, 20, 26, 16], [1, 7, 19, 27, 13], [2, 8, 20, 26, 14], [2, 8, 18, 26, 14], [3, 9, 19, 25, 15], [1, 9, 21, 29, 15], [2, 10, 22, 28, 16], [2, 10, 20, 28, 16], [3, 11, 21, 27, 17], [2, 8, 20, 28, 14], [3, 9, 21, 27, 15], [3, 9, 19, 27, 15], [4, 10, 20, 26, 16]]],\n          [[[-2, 6, 16, 24, 11], [-1, 7, 17, 23, 12], [-1, 7, 15, 23, 12], [0, 8, 16, 22, 13], [-1, 5, 15, 23, 10], [0, 6, 16, 22, 11], [0, 6, 14, 22, 11], [1, 7, 15, 21, 12], [2, 10, 20, 28, 15], [3, 11, 21, 27, 16], [3, 11, 19, 27, 16], [4, 12, 20, 26, 17], [3, 9, 19, 27, 14], [4, 10, 20, 26, 15], [4, 10, 18, 26, 15], [5, 11, 19, 25, 16], [3, 11, 21, 29, 16], [4, 12, 22, 28, 17], [4, 12, 20, 28, 17], [5, 13, 21, 27, 18], [4, 10, 20, 28, 15], [5, 11, 21, 27, 16], [5, 11, 19, 27, 16], [6, 12, 20, 26, 17]], [[-2, 6, 16, 24, 11], [-1, 7, 17, 23, 12], [-1, 7, 15, 23, 12], [0, 8, 16, 22, 13], [-1, 5, 15, 23, 10], [0, 6, 16, 22, 11], [0, 6, 14, 22, 11], [1, 7, 15, 21, 12], [2, 10, 20, 28, 15], [3, 11, 21, 27, 16], [3, 11, 19, 27, 16], [4, 12, 20, 26, 17], [3, 9, 19, 27, 14], [4, 10, 20, 26, 15], [4, 10, 18, 26, 15], [5, 11, 19, 25, 16], [3, 11, 21, 29, 16], [4, 12, 22, 28, 17], [4, 12, 20, 28, 17], [5, 13, 21, 27, 18], [4, 10, 20, 28, 15], [5, 11, 21, 27, 16], [5, 11, 19, 27, 16], [6, 12, 20, 26, 17]]],\n          [[[0, 4, 18, 25, 11], [1, 5, 19, 24, 12], [1, 5, 17, 24, 12], [2, 6, 18, 23, 13], [1, 3, 17, 24, 10], [2, 4, 18, 23, 11], [2, 4, 16, 23, 11], [3, 5, 17, 22, 12], [0, 7, 21, 28, 14], [1, 8, 22, 27, 15], [1, 8, 20, 27, 15], [2, 9, 21, 26, 16], [1, 6, 20, 27, 13], [2, 7, 21, 26, 14], [2, 7, 19, 26, 14], [3, 8, 20, 25, 15], [1, 8, 22, 29, 15], [2, 9, 23, 28, 16], [2, 9, 21, 28, 16], [3, 10, 22, 27, 17], [2, 7, 21, 28, 14], [3, 8, 22, 27, 15], [3, 8, 20, 27, 15], [4, 9, 21, 26, 16]], [[0, 4, 18, 25, 11], [1, 5, 19, 24, 12], [1, 5, 17, 24, 12], [2, 6, 18, 23, 13], [1, 3, 17, 24, 10], [2, 4, 18, 23, 11], [2, 4, 16, 23, 11], [3, 5, 17, 22, 12], [0, 7, 21, 28, 14], [1, 8, 22, 27, 15], [1, 8, 20, 27, 15], [2, 9, 21, 26, 16], [1, 6, 20, 27, 13], [2, 7, 21, 26, 14], [2, 7, 19, 26, 14], [3, 8, 20, 25, 15], [1, 8, 22, 29, 15], [2, 9, 23, 28, 16], [2, 9, 21, 28, 16], [3, 10, 22, 27, 17], [2, 7, 21, 28, 14], [3, 8, 22, 27, 15], [3, 8, 20, 27, 15], [4, 9, 21, 26, 16]]]\n        ],\n        fonts: {\n          bmp_small_digits: [[3, 5, \" # # ## ## # # \"], [2, 5, \" ### # # #\"], [3, 5, \"##   # # #  ###\"], [3, 5, \"##   # #   ### \"], [3, 5, \"# ## ####  #  #\"], [3, 5, \"####  ##   ### \"], [3, 5, \" ###  ## # # # \"], [3, 5, \"###  # #  #  # \"], [3, 5, \" # # # # # # # \"], [3, 5, \" # # # ##  ### \"]]\n        },\n        languages: [\n          {\n            month_raise: 0,\n            months: [[10, 5, \" #         #  ##  ## # # # # # # ### # ##  # # # #\"], [10, 5, \"###    #  #   ## #  ## ##  ## #  #   # ##   ## ## \"], [13, 5, \"#   #        ## ##  ## ## # # # # # # ##   # ### ## #   # # # # #\"], [11, 5, \" ##        # # ##  ## ### # # # ## # ##  ## # # #   # #\"], [13, 5, \"#   #        ## ##  ## # ## # # # # # ##   # ###  # #   # # # #  \"], [10, 5, \" #         # # #  ## # # # # # # # # # ##   ## # #\"], [9, 5, \" #        # # # #  # # # #  # # # # #   ## ##\"], [11, 5, \" ##        # # # #  ##### # # #  # # # # # ## #  ##  ##\"], [11, 5, \" ##        #    ## ##  #  ##  # #  # #   ## ##   ## #  \"], [10, 5, \" ##     # # #  ## ### # #   # # # #   # ###  ##  #\"], [12, 5, \"#  #        #  #  ## # ### # # # # ## ## # # # ##  # ##   # \"], [11, 5, \"##         # #  ##  ### # ##  #  # # #   #  ##   ##  ##\"]],\n            marked_weekdays: [[5, 5, \" ###  #    ###    #  ### \"], [7, 5, \" #   #  ## ##  # # #  #   #  #   # \"], [5, 5, \" ###   #    #    #    #  \"], [7, 5, \" #   #  #   #  #   #  # # #  ## ## \"], [5, 5, \" ###   #    #    #    #  \"], [5, 5, \" ###  #    ##   #    #   \"], [5, 5, \" ###  #    ###    #  ### \"], [4, 5, \"         ##  ##     \"], [6, 5, \"       ####  #  #  #  #  #### \"]],\n            weekdays: [[11, 5, \" ##        #   # #  ## #  # # # #  # # # # ###   ## # #\"], [13, 5, \"#   #        ## ##  ##  ### # # # # # ##   # # # # ##   # ##  # #\"], [11, 5, \"###         #  # #  ## #  # # ##  #  # # #   #   ##  ##\"], [13, 5, \"#   #       ##   #  ##   ##   # ##   ### # # #   # ### ##  ##  ##\"], [11, 5, \"### #       #  #   # # #  ##  # # #  # # # # #  # #  ##\"], [9, 5, \"###     ##   ##   ##  # # ##   ##  ##   # # #\"], [10, 5, \" ##     # #    ## ## #  # # #   # ### # ##  # #  #\"]]\n          },\n          {\n            month_raise: 1,\n            months: [[8, 6, \"    #  # ##     #   #  # #  #  #  # #  ###  # # \"], [9, 6, \"        ## #      # # #   ## # #   ## # #   # #  ## # \"], [10, 6, \"    ##     ##       # # ## # ## #  # # ## # #  # #### ##  ##\"], [11, 6, \"           ###         #  ##   ## #  # # # # #  ##  ### #  # # # #\"], [9, 6, \"        # ##      #   # # # #  # # #  # # # ###   #  #\"], [8, 6, \"   #    #       #  # ## #  # # ##  # ## ## # #  \"], [11, 6, \"            ##        #   ##  ##  #  # # # #  # ##  ## ##  # # #  \"], [10, 6, \"          # #       # #  ## # ##  # # # # # # # # # # ##  ##\"], [10, 6, \"         ###        # # # #  ###  # #  ## # # #  ## #  ## # \"], [7, 6, \"   #   #      #  #  ##  # # #  #  ### # # \"], [11, 6, \"            ##  #     #   ### # # #   #  # #  #  #  # ###   #   ##\"], [11, 6, \"           ##         # # ##   ####  # # # ##   ##  # ##   # # ## \"]],\n            marked_weekdays: [[6, 5, \" #  #  ## #  # ##  #  #  #  # \"], [5, 5, \" ###  # #  ###  #    #   \"], [5, 5, \" # #  # #  # #  # #  ### \"], [5, 5, \" ###  #    ###    #  ### \"], [5, 5, \"  ##  ###  #    #    ### \"], [5, 5, \" ###  # #  ###  #    #   \"], [5, 5, \" ###  #    ###    #  ### \"], [4, 5, \"         ##  ##     \"], [6, 5, \"       ####  #  #  #  #  #### \"]],\n            weekdays: [[12, 5, \"#  #       ##  #  ##   ### # ##   ### ## #   # ##  #  ##  ##\"], [10, 5, \"##        # # ##  #### # # # ##  # # # ##  ##  # #\"], [10, 5, \"# # #     # # ##  ### # #  # ## # #  # # ##  # ## \"], [9, 5, \" ##     ##   ##    #  # # #  # ##  ###  # # #\"], [10, 5, \" ##     #  ##  ## ###   ##  # #   #   #  ##  ##  #\"], [9, 5, \"##     # # # ## #### ##  # #  #   # #   ##  #\"], [11, 5, \" ##     #  #   # # #   #  # # ##   # # # # ###   ## ## \"]]\n          }\n        ]\n      };\n      // END generated\n    <\/script>\n    <script type=\"text/javascript\">\n      // Replaced with the current options by the phone app when it serves\n      // this page itself; when loaded from the web they come in the query.\n      var inlined_options = {} /* options */;\n\n      function each(selector, callback) {\n        var elements = document.querySelectorAll(selector);\n        for (var i = 0; i < elements.length; ++i) {\n          callback(elements[i]);\n        }\n      }\n      function parse_options() {\n        var options = inlined_options;\n      \n        var prefix = \"?options=\";\n        if (location.search && location.search.indexOf(prefix) == 0) {\n          var json_str = unescape(location.search.substring(prefix.length));\n          options = JSON.parse(json_str);\n        }\n        console.log(\"Got options: \" + JSON.stringify(options));\n\n        for (var key in options) {\n          var radio = document.getElementById(key + \"_\" + options[key]);\n          if (radio && radio.type == \"radio\") {\n            radio.checked = true;\n          }\n          var input = document.getElementById(key);\n          if (input && input.type == \"checkbox\") {\n            input.checked = Number(options[key]) != 0;\n          } else if (input && input.type == \"text\") {\n            input.value = options[key];\n          }\n        }\n        each(\".advanced_checkbox\", function (element) { element.onclick(); });\n        preview_start();\n      }\n      function is_visible(element) {\n        return element.offsetParent !== null;\n      }\n      function read_options() {\n        var options = {};\n      \n        each(\"input[type=radio]\", function (element) {\n          if (element.checked) {\n            options[element.name] = Number(element.value);\n          }\n        });\n        each(\"input[type=checkbox]\", function (element) {\n          options[element.id] = Number(element.checked);\n        });\n        each(\"input[type=text]\", function (element) {\n          if (is_visible(element) && element.value.trim() !== \"\" && !isNaN(element.value)) {\n            options[element.id] = Number(element.value);\n          }\n        });\n        return options;\n      }\n      function save() {\n        var options = read_options();\n        console.log(\"Save: \" + JSON.stringify(options));\n        document.location = \"pebblejs://close#\" + encodeURIComponent(JSON.stringify(options));\n      }\n      // closes without saving, the phone app asks the watch for its log\n      function read_log() {\n        console.log(\"Read log\");\n        document.location = \"pebblejs://close#\" + encodeURIComponent(JSON.stringify({\"LOG_DUMP\": 0}));\n      }\n      function cancel() {\n        console.log(\"Cancel\");\n        document.location = \"pebblejs://close\";\n      }\n      function set_visible(target, value) {\n        console.log(\"Making \" + target + \" visible=\" + value);\n        each(\".\" + target, function (element) {\n          element.style.display = value ? \"\" : \"none\";\n        });\n      }\n    <\/script>\n    <script type=\"text/javascript\">\n      // Live preview, a port of the field, the digit animation and the date\n      // layout of TetrisTime.c drawn into a canvas. The tables come from the\n      // generated block above; the logic has to follow the watchface by hand.\n      var C = PREVIEW_DATA.constants;\n\n      var PREVIEW_PLATFORMS = {\n        aplite: { color: false, round: false, width: 144, height: 168, offset_x: 0, offset_y: 1 },\n        basalt: { color: true, round: false, width: 144, height: 168, offset_x: 0, offset_y: 1 },\n        chalk: { color: true, round: true, width: 180, height: 180, offset_x: 0, offset_y: 0 }\n      };\n\n      var PREVIEW_PAUSE_MS = 1500;\n      var DIGIT_COLON = 10;\n\n      // glyphs become objects once, date slots compare them by identity\n      function load_glyphs(glyphs) {\n        return glyphs.map(function (glyph) {\n          return { width: glyph[0], height: glyph[1], data: glyph[2] };\n        });\n      }\n      var FONTS = {};\n      for (var font in PREVIEW_DATA.fonts) {\n        FONTS[font] = load_glyphs(PREVIEW_DATA.fonts[font]);\n      }\n      // date glyphs per language, indexed by DATE_LANGUAGE\n      var LANGUAGES = PREVIEW_DATA.languages.map(function (language) {\n        return {\n          months: load_glyphs(language.months),\n          marked_weekdays: load_glyphs(language.marked_weekdays),\n          weekdays: load_glyphs(language.weekdays)\n        };\n      });\n\n      var s_preview_timer = null;\n\n      // field.h\n\n      function field_create(platform) {\n        var pitch = C.CELL_SIZE + C.CELL_SPACING;\n        var field = {\n          platform: platform,\n          pitch: pitch,\n          width: Math.floor((platform.width - platform.offset_x + C.CELL_SPACING) / pitch),\n          height: Math.floor((platform.height - platform.offset_y + C.CELL_SPACING) / pitch),\n          row_begin: [],\n          row_end: [],\n          cells: []\n        };\n        // as field_init_visibility, in half-pixels\n        var radius = platform.width;\n        for (var j = 0; j < field.height; ++j) {\n          field.row_begin[j] = 0;\n          field.row_end[j] = field.width;\n          if (!platform.round) {\n            continue;\n          }\n          var cy = 2 * (platform.offset_y + j * pitch) + C.CELL_SIZE - platform.height;\n          var dy = Math.max(Math.abs(cy) - C.CELL_SIZE, 0);\n          field.row_begin[j] = field.width;\n          field.row_end[j] = 0;\n          for (var i = 0; i < field.width; ++i) {\n            var cx = 2 * (platform.offset_x + i * pitch) + C.CELL_SIZE - platform.width;\n            var dx = Math.max(Math.abs(cx) - C.CELL_SIZE, 0);\n            if (dx * dx + dy * dy < radius * radius) {\n              field.row_begin[j] = Math.min(field.row_begin[j], i);\n              field.row_end[j] = i + 1;\n            }\n          }\n        }\n        return field;\n      }\n\n      function field_fill_rows(field, y_begin, y_end, color) {\n        for (var j = Math.max(y_begin, 0); j < Math.min(y_end, field.height); ++j) {\n          for (var i = 0; i < field.width; ++i) {\n            field.cells[j * field.width + i] = color;\n          }\n        }\n      }\n\n      function field_draw(field, x, y, color) {\n        if (y >= 0 && y < field.height && x >= field.row_begin[y] && x < field.row_end[y]) {\n          field.cells[y * field.width + x] = color;\n        }\n      }\n\n      function argb8_color(argb) {\n        var channel = function (shift) { return ((argb >> shift) & 3) * 85; };\n        return \"rgb(\" + channel(4) + \",\" + channel(2) + \",\" + channel(0) + \")\";\n      }\n\n      // settings.h, the parts of settings_apply that change what is drawn\n\n      function in_range(value, min, max) {\n        return value < min ? min : (value > max ? max : value);\n      }\n\n      function preview_settings(options) {\n        var s = {};\n        for (var key in PREVIEW_DATA.defaults) {\n          s[key] = key in options ? options[key] : PREVIEW_DATA.defaults[key];\n        }\n        if (s.DATE_WEEKDAY_FORMAT == 2 && (s.DATE_MONTH_FORMAT == 2 || s.DATE_MONTH_FORMAT == 3)) {\n          s.DATE_WEEKDAY_FORMAT = 3;\n        }\n        if (!s.CUSTOM_DATE) {\n          s.CUSTOM_TIME_OFFSET = s.DATE_MODE != 2 ? [1, 2, 4, 1][s.DATE_WEEKDAY_FORMAT] : 0;\n          s.CUSTOM_TIME_DATE_SPACING_1 = 2;\n          s.CUSTOM_TIME_DATE_SPACING_2 = 4;\n          s.CUSTOM_DATE_WORD_SPACING = 2;\n          s.CUSTOM_DATE_LINE_SPACING = 2;\n          if (s.DATE_WEEKDAY_FORMAT == 3) {\n            s.CUSTOM_TIME_DATE_SPACING_1 += 1;\n            s.CUSTOM_TIME_DATE_SPACING_2 += 1;\n          }\n        } else {\n          each_key([\"CUSTOM_TIME_OFFSET\", \"CUSTOM_TIME_DATE_SPACING_1\", \"CUSTOM_TIME_DATE_SPACING_2\",\n                    \"CUSTOM_DATE_WORD_SPACING\", \"CUSTOM_DATE_LINE_SPACING\"], function (key) {\n            s[key] = in_range(s[key], 0, 20);\n          });\n        }\n        if (!s.CUSTOM_ANIMATIONS) {\n          s.CUSTOM_ANIMATION_TIMEOUT_MS = 90;\n          s.CUSTOM_ANIMATION_PERIOD_VIS_FRAMES = 2;\n          s.CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES = 1;\n          s.CUSTOM_ANIMATION_PERIOD_COUNT = 3;\n          s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES = 4;\n          s.CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES = 5;\n        } else {\n          s.CUSTOM_ANIMATION_TIMEOUT_MS = in_range(s.CUSTOM_ANIMATION_TIMEOUT_MS, 10, 10000);\n          s.CUSTOM_ANIMATION_PERIOD_VIS_FRAMES = in_range(s.CUSTOM_ANIMATION_PERIOD_VIS_FRAMES, 1, 20);\n          s.CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES = in_range(s.CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES, 1, 20);\n          s.CUSTOM_ANIMATION_PERIOD_COUNT = in_range(s.CUSTOM_ANIMATION_PERIOD_COUNT, 0, 20);\n          s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES = in_range(s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES, 1, 20);\n          s.CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES = in_range(s.CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES, 0, 50);\n        }\n        return s;\n      }\n\n      function each_key(keys, callback) {\n        for (var i = 0; i < keys.length; ++i) {\n          callback(keys[i]);\n        }\n      }\n\n      // tetrimino.h and digit.h\n\n      function random(count) {\n        return Math.floor(Math.random() * count);\n      }\n\n      function copy_pos(tp) {\n        return { letter: tp.letter, rotation: tp.rotation, x: tp.x, y: tp.y };\n      }\n\n      function pos_equal(a, b) {\n        return a.letter == b.letter && a.rotation == b.rotation && a.x == b.x && a.y == b.y;\n      }\n\n      function tetrimino_cells(tp, callback) {\n        var mask = PREVIEW_DATA.tetriminos[tp.letter].rotations[tp.rotation];\n        for (var mask_y = 0; mask_y < C.TETRIMINO_MASK_SIZE; ++mask_y) {\n          for (var mask_x = 0; mask_x < C.TETRIMINO_MASK_SIZE; ++mask_x) {\n            if (mask.charAt(mask_y * C.TETRIMINO_MASK_SIZE + mask_x) != \" \") {\n              callback(tp.x + mask_x, tp.y + mask_y);\n            }\n          }\n        }\n      }\n\n      function load_digit(value, order) {\n        var indices = PREVIEW_DATA.orders[value][order];\n        return indices.map(function (index) {\n          var t = PREVIEW_DATA.digits[value][index];\n          return { letter: t[0], rotation: t[1], x: t[2], y: t[3] };\n        });\n      }\n\n      // TetrisTime.c\n\n      function max_tetrimino_age(sim) {\n        return C.MAX_TETRIMINO_AGE_STEPS * sim.settings.CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES;\n      }\n\n      function animation_period_frames(sim) {\n        return sim.settings.CUSTOM_ANIMATION_PERIOD_VIS_FRAMES + sim.settings.CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES;\n      }\n\n      function state_create(offset_y) {\n        return {\n          offset_x: 0, next_offset_x: 0, offset_y: offset_y,\n          falling: false,\n          target_value: -1, next_value: -1,\n          target: [], current: [], ages: [],\n          action_height: 0, vanishing_frame: 0, start_delay: 0,\n          planned_value: -1, planned_offset_x: 0, shared_count: 0, keep_mask: 0,\n          restricted_spawn_width: false\n        };\n      }\n\n      function state_falling_tetriminos(state) {\n        if (!state.falling) {\n          return 0;\n        }\n        var count = 0;\n        for (var i = 0; i < state.current.length; ++i) {\n          if (!pos_equal(state.current[i], state.target[i])) {\n            count += 1;\n          }\n        }\n        return count;\n      }\n\n      function mark_columns(deepest, tp) {\n        tetrimino_cells(tp, function (x, y) {\n          if (x >= 0 && x < C.DIGIT_WIDTH && deepest[x] < y) {\n            deepest[x] = y;\n          }\n        });\n      }\n\n      function is_above(deepest, tp) {\n        var above = false;\n        tetrimino_cells(tp, function (x, y) {\n          if (x >= 0 && x < C.DIGIT_WIDTH && deepest[x] > y) {\n            above = true;\n          }\n        });\n        return above;\n      }\n\n      function state_plan_transition(state) {\n        var next = load_digit(state.next_value, random(C.DIGIT_ORDER_COUNT));\n        var match = [];\n        var used = 0;\n        for (var j = 0; j < next.length; ++j) {\n          var np = next[j];\n          match[j] = -1;\n          for (var i = 0; i < state.current.length; ++i) {\n            var cp = state.current[i];\n            if (!(used & (1 << i)) && cp.letter == np.letter && cp.rotation == np.rotation && cp.y == np.y &&\n                cp.x + state.offset_x == np.x + state.next_offset_x) {\n              match[j] = i;\n              used |= 1 << i;\n              break;\n            }\n          }\n        }\n\n        var changed = true;\n        while (changed) {\n          var deepest = [];\n          for (var x = 0; x < C.DIGIT_WIDTH; ++x) {\n            deepest[x] = -1;\n          }\n          for (j = 0; j < next.length; ++j) {\n            if (match[j] < 0) {\n              mark_columns(deepest, next[j]);\n            }\n          }\n          changed = false;\n          for (j = 0; j < next.length; ++j) {\n            if (match[j] >= 0 && is_above(deepest, next[j])) {\n              match[j] = -1;\n              changed = true;\n            }\n          }\n        }\n\n        state.target = [];\n        state.keep_mask = 0;\n        for (j = 0; j < next.length; ++j) {\n          if (match[j] >= 0) {\n            state.target.push(next[j]);\n            state.keep_mask |= 1 << match[j];\n          }\n        }\n        state.shared_count = state.target.length;\n        for (j = 0; j < next.length; ++j) {\n          if (match[j] < 0) {\n            state.target.push(next[j]);\n          }\n        }\n        state.planned_value = state.next_value;\n        state.planned_offset_x = state.next_offset_x;\n      }\n\n      function state_step(sim, state) {\n        var max_age = max_tetrimino_age(sim);\n        if (!state.falling) {\n          if (state.next_value == state.target_value && state.next_offset_x == state.offset_x) {\n            return;\n          }\n          if (state.start_delay) {\n            state.start_delay -= 1;\n            return;\n          }\n          if (state.planned_value != state.next_value || state.planned_offset_x != state.next_offset_x) {\n            state_plan_transition(state);\n          }\n          var nothing_vanishes = state.current.length > 0 && state.keep_mask == (1 << state.current.length) - 1;\n          if (!nothing_vanishes && state.vanishing_frame <= sim.settings.CUSTOM_ANIMATION_PERIOD_COUNT * animation_period_frames(sim)) {\n            state.vanishing_frame += 1;\n            return;\n          }\n          state.target_value = state.next_value;\n          state.offset_x = state.next_offset_x;\n          state.current = state.target.slice(0, state.shared_count).map(copy_pos);\n          state.ages = state.current.map(function () { return max_age; });\n          state.keep_mask = 0;\n          state.falling = true;\n          state.vanishing_frame = 0;\n        }\n\n        var last_y = C.TETRIMINO_MASK_SIZE;\n        for (var i = 0; i < state.current.length; ++i) {\n          var current_pos = state.current[i];\n          var target_pos = state.target[i];\n\n          var height_remaining = target_pos.y - current_pos.y;\n          var moves_needed = Math.abs(target_pos.x - current_pos.x);\n          var rotations_needed = target_pos.rotation - current_pos.rotation;\n          if (rotations_needed < 0) {\n            rotations_needed += 4;\n          }\n          var actions_needed = moves_needed + rotations_needed;\n\n          if (state.action_height >= current_pos.y) {\n            state.action_height = current_pos.y + ((height_remaining / (actions_needed + 1)) | 0);\n          }\n\n          if (current_pos.y < target_pos.y) {\n            current_pos.y += 1;\n          } else if (state.ages[i] < max_age) {\n            state.ages[i] += 1;\n          }\n\n          if (current_pos.y >= state.action_height) {\n            if (moves_needed > rotations_needed) {\n              current_pos.x += current_pos.x < target_pos.x ? 1 : (current_pos.x > target_pos.x ? -1 : 0);\n            } else if (rotations_needed) {\n              current_pos.rotation = (current_pos.rotation + 1) % 4;\n            }\n          }\n\n          if (i >= state.shared_count) {\n            last_y = current_pos.y;\n          }\n        }\n\n        if (state.current.length < state.target.length) {\n          var target = state.target[state.current.length];\n          var td = PREVIEW_DATA.tetriminos[target.letter];\n          var start_y = -state.offset_y - td.size + 1;\n          if (sim.spawn_budget > 0 && last_y >= start_y + C.ANIMATION_SPACING_Y) {\n            sim.spawn_budget -= 1;\n            var spawn_width = state.restricted_spawn_width ? 4 : C.DIGIT_WIDTH;\n            state.current.push({\n              letter: target.letter,\n              rotation: (target.rotation - random(td.unique) + 4) % 4,\n              x: random(spawn_width - td.size + 1) + ((C.DIGIT_WIDTH - spawn_width) / 2 | 0),\n              y: start_y\n            });\n            state.action_height = start_y;\n            state.ages.push(0);\n          }\n        }\n\n        var last = state.current.length - 1;\n        if (state.current.length == state.target.length &&\n            (last < 0 || (pos_equal(state.current[last], state.target[last]) && state.ages[last] >= max_age))) {\n          state.falling = false;\n        }\n      }\n\n      function add_date_slot(slots, offset, bmp, y, spacing) {\n        slots.push({ bmp: bmp, x: offset.x, y: y, frame: 0 });\n        offset.x += bmp.width + spacing;\n      }\n\n      function date_font(sim, name) {\n        return LANGUAGES[sim.settings.DATE_LANGUAGE][name];\n      }\n\n      function layout_weekday_line(sim, slots, height) {\n        var bmp = date_font(sim, \"weekdays\")[sim.weekday];\n        add_date_slot(slots, { x: (sim.field.width - bmp.width + 1) >> 1 }, bmp, height, 0);\n      }\n\n      function layout_marked_weekday_line(sim, slots, height, use_letter) {\n        var marked_weekdays = date_font(sim, \"marked_weekdays\");\n        var glyphs = [];\n        var width = 0;\n        for (var i = 0; i < 7; ++i) {\n          var day = (sim.settings.DATE_FIRST_WEEKDAY + i) % 7;\n          glyphs[i] = marked_weekdays[day == sim.weekday ? (use_letter ? day : 8) : 7];\n          width += glyphs[i].width;\n        }\n        var offset = { x: (sim.field.width - width + 1) >> 1 };\n        for (i = 0; i < 7; ++i) {\n          add_date_slot(slots, offset, glyphs[i], height, 0);\n        }\n      }\n\n      function layout_date_line(sim, slots, height) {\n        var s = sim.settings;\n        var dmf = s.DATE_MONTH_FORMAT;\n        var month = date_font(sim, \"months\")[sim.month];\n        var weekday = date_font(sim, \"weekdays\")[sim.weekday];\n        var digits = FONTS.bmp_small_digits;\n        // croatian months are taller because of the caron\n        var extra_height = PREVIEW_DATA.languages[s.DATE_LANGUAGE].month_raise;\n        var spacing = s.CUSTOM_DATE_WORD_SPACING;\n\n        var width = C.BMP_SMALL_DIGIT_WIDTH;\n        if (sim.day >= 10) {\n          width += 1 + C.BMP_SMALL_DIGIT_WIDTH;\n        }\n        if (dmf == 0 || dmf == 1) {\n          width += month.width + spacing;\n        } else {\n          width += weekday.width + spacing;\n        }\n\n        var offset = { x: (sim.field.width - width + 1) >> 1 };\n        if (dmf == 0) {\n          add_date_slot(slots, offset, month, height - extra_height, spacing);\n        } else if (dmf == 2) {\n          add_date_slot(slots, offset, weekday, height, spacing);\n        }\n        if (sim.day >= 10) {\n          add_date_slot(slots, offset, digits[Math.floor(sim.day / 10)], height, 1);\n        }\n        add_date_slot(slots, offset, digits[sim.day % 10], height, spacing);\n        if (dmf == 1) {\n          add_date_slot(slots, offset, month, height - extra_height, spacing);\n        } else if (dmf == 3) {\n          add_date_slot(slots, offset, weekday, height, spacing);\n        }\n      }\n\n      function get_final_date_split_height(sim) {\n        return sim.states[0].offset_y + C.DIGIT_HEIGHT + sim.settings.CUSTOM_TIME_DATE_SPACING_1;\n      }\n\n      function date_update(sim, animate) {\n        var s = sim.settings;\n        var slots = [];\n        if (s.DATE_MODE != 2) {\n          var first_line_height = s.CUSTOM_TIME_DATE_SPACING_2;\n          var second_line_height = first_line_height + C.BMP_SMALL_HEIGHT + s.CUSTOM_DATE_LINE_SPACING;\n          layout_date_line(sim, slots, first_line_height);\n          if (s.DATE_WEEKDAY_FORMAT == 0) {\n            layout_marked_weekday_line(sim, slots, second_line_height - 1, false);\n          } else if (s.DATE_WEEKDAY_FORMAT == 1) {\n            layout_marked_weekday_line(sim, slots, second_line_height, true);\n          } else if (s.DATE_WEEKDAY_FORMAT == 2) {\n            layout_weekday_line(sim, slots, second_line_height);\n          }\n        }\n        slots.forEach(function (slot) {\n          if (animate) {\n            slot.frame = slot.bmp.height * s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES;\n          }\n          for (var j = 0; j < sim.date_slots.length; ++j) {\n            var old = sim.date_slots[j];\n            if (old.bmp === slot.bmp && old.x == slot.x && old.y == slot.y) {\n              slot.frame = animate ? old.frame : 0;\n              break;\n            }\n          }\n        });\n        sim.date_slots = slots;\n      }\n\n      function draw_bitmap_rows(sim, bmp, x, y, row_begin, color) {\n        for (var j = row_begin; j < bmp.height; ++j) {\n          for (var i = 0; i < bmp.width; ++i) {\n            if (bmp.data.charAt(j * bmp.width + i) != \" \") {\n              field_draw(sim.field, x + i, y + j, color);\n            }\n          }\n        }\n      }\n\n      function draw_date(sim) {\n        var s = sim.settings;\n        if (s.DATE_MODE == 2) {\n          return;\n        }\n        var period = s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES;\n        var split_height = get_final_date_split_height(sim) + Math.floor((sim.date_frame + period - 1) / period);\n        var date_color = sim.fg_color;\n        if (s.DATE_MODE == 0) {\n          date_color = sim.bg_color;\n          field_fill_rows(sim.field, split_height, sim.field.height, sim.fg_color);\n        }\n        sim.date_slots.forEach(function (slot) {\n          var hidden_rows = Math.floor((slot.frame + period - 1) / period);\n          draw_bitmap_rows(sim, slot.bmp, slot.x, split_height + slot.y, hidden_rows, date_color);\n        });\n      }\n\n      function step_channel(current, target, max_step) {\n        if (current > target) return current - Math.min(max_step, current - target);\n        if (current < target) return current + Math.min(max_step, target - current);\n        return current;\n      }\n\n      // fade steps from the tetrimino color to the foreground, as built in\n      // on_settings_changed\n      function tetrimino_colors(td, fg) {\n        var colors = [];\n        for (var age_step = 0; age_step < C.TETRIMINO_FADE_STEPS; ++age_step) {\n          var argb = 0xC0;\n          for (var shift = 0; shift < 6; shift += 2) {\n            argb |= step_channel((td.color >> shift) & 3, (fg >> shift) & 3, age_step) << shift;\n          }\n          colors.push(argb8_color(argb));\n        }\n        return colors;\n      }\n\n      function draw_tetrimino(sim, tp, offset_x, offset_y, age) {\n        var color = sim.fg_color;\n        var step_frames = sim.settings.CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES;\n        if (sim.field.platform.color && age < max_tetrimino_age(sim)) {\n          color = sim.tetrimino_colors[tp.letter][Math.min(Math.floor(age / step_frames), C.TETRIMINO_FADE_STEPS - 1)];\n        }\n        tetrimino_cells(tp, function (x, y) {\n          field_draw(sim.field, x + offset_x, y + offset_y, color);\n        });\n      }\n\n      function draw_digit_state(sim, state) {\n        var hide_vanishing = false;\n        if (state.vanishing_frame) {\n          var in_period = (state.vanishing_frame - 1) % animation_period_frames(sim);\n          hide_vanishing = in_period < sim.settings.CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES;\n        }\n        for (var i = 0; i < state.current.length; ++i) {\n          // tetriminos shared with the next digit don't blink\n          if (!hide_vanishing || (state.keep_mask & (1 << i))) {\n            draw_tetrimino(sim, state.current[i], state.offset_x, state.offset_y, state.ages[i]);\n          }\n        }\n      }\n\n      // what layer_draw paints on a full redraw; the colon stays lit\n      function render_frame(sim) {\n        var field = sim.field;\n        field_fill_rows(field, 0, field.height, sim.bg_color);\n        sim.states.forEach(function (state) {\n          draw_digit_state(sim, state);\n        });\n        draw_date(sim);\n        return field.cells.slice();\n      }\n\n      function is_animating(sim) {\n        if (sim.date_frame) {\n          return true;\n        }\n        for (var i = 0; i < sim.date_slots.length; ++i) {\n          if (sim.date_slots[i].frame) {\n            return true;\n          }\n        }\n        for (i = 0; i < sim.states.length; ++i) {\n          var state = sim.states[i];\n          if (state.falling || state.vanishing_frame || state.start_delay) {\n            return true;\n          }\n        }\n        return false;\n      }\n\n      function process_animation(sim) {\n        if (sim.date_frame) {\n          sim.date_frame -= 1;\n        }\n        sim.date_slots.forEach(function (slot) {\n          if (slot.frame) {\n            slot.frame -= 1;\n          }\n        });\n        var falling = 0;\n        sim.states.forEach(function (state) {\n          falling += state_falling_tetriminos(state);\n        });\n        sim.spawn_budget = C.MAX_FALLING_TETRIMINOS - falling;\n        sim.states.forEach(function (state) {\n          state_step(sim, state);\n        });\n        sim.frames.push(render_frame(sim));\n        sim.animating = is_animating(sim);\n      }\n\n      function tick(sim, time, initial, units_day) {\n        if (units_day) {\n          sim.month = time.getMonth();\n          sim.day = time.getDate();\n          sim.weekday = time.getDay();\n          date_update(sim, !initial);\n        }\n\n        var hour = time.getHours();\n        if (!sim.clock24) {\n          hour = hour % 12 || 12;\n        }\n        var values = [Math.floor(hour / 10), hour % 10, Math.floor(time.getMinutes() / 10), time.getMinutes() % 10, DIGIT_COLON];\n        if (values[0] == 0) {\n          values[0] = C.DIGIT_COUNT;\n        }\n        var leading = values[0] == C.DIGIT_COUNT ? 0 : (values[0] == 2 ? 2 : 1);\n        var layout_key = leading * 8 + (values[1] == 1) * 4 + (values[2] == 1) * 2 + (values[3] == 1);\n        var layout = PREVIEW_DATA.layouts[sim.settings.DIGITS_MODE][sim.clock24 ? 1 : 0][layout_key];\n        var layout_offset_x = (sim.field.width - C.LAYOUT_FIELD_WIDTH) >> 1;\n\n        var changed = 0;\n        sim.states.forEach(function (state, i) {\n          var offset = layout[i] + layout_offset_x;\n          if (state.next_value != values[i] || state.next_offset_x != offset) {\n            state.next_value = values[i];\n            state.next_offset_x = offset;\n            // stagger digits changing together, single digit changes start at once\n            if (!state.falling && !state.vanishing_frame) {\n              state.start_delay = changed * C.DIGIT_START_STAGGER_FRAMES;\n            }\n            changed += 1;\n          }\n        });\n        if ((changed || is_animating(sim)) && !sim.animating) {\n          process_animation(sim);\n        }\n      }\n\n      // plays the animation to its end without keeping the frames\n      function settle(sim) {\n        while (sim.animating) {\n          process_animation(sim);\n        }\n        sim.frames = [];\n      }\n\n      function simulate(settings, platform, clock24, transition) {\n        var s = settings;\n        var sim = {\n          settings: s,\n          clock24: clock24,\n          field: field_create(platform),\n          states: [],\n          date_slots: [],\n          date_frame: 0,\n          spawn_budget: 0,\n          animating: false,\n          frames: []\n        };\n\n        var light = s.LIGHT_THEME;\n        var fg = light ? 0xC0 : 0xFF;\n        sim.bg_color = argb8_color(light ? 0xFF : 0xC0);\n        sim.fg_color = argb8_color(fg);\n        sim.tetrimino_colors = {};\n        for (var letter in PREVIEW_DATA.tetriminos) {\n          sim.tetrimino_colors[letter] = tetrimino_colors(PREVIEW_DATA.tetriminos[letter], fg);\n        }\n\n        var offset_y = (sim.field.height - C.DIGIT_HEIGHT) >> 1;\n        if (s.DATE_MODE != 2) {\n          offset_y -= s.CUSTOM_TIME_OFFSET;\n        }\n        for (var i = 0; i < C.STATE_COUNT; ++i) {\n          sim.states.push(state_create(offset_y));\n        }\n        sim.states[4].restricted_spawn_width = true;\n\n        var to = new Date();\n        to.setSeconds(0, 0);\n        if (transition == \"hour\") {\n          to.setHours(13, 0);\n        } else if (transition == \"day\") {\n          to.setHours(0, 0);\n          to.setDate(to.getDate() + 1);\n        } else if (transition == \"minute\") {\n          to.setMinutes(to.getMinutes() + 1);\n        }\n\n        if (transition == \"appear\") {\n          // as main_window_load\n          tick(sim, to, true, true);\n          if (!s.SKIP_INITIAL_ANIMATION) {\n            sim.date_frame = (sim.field.height - get_final_date_split_height(sim)) * s.CUSTOM_ANIMATION_DATE_PERIOD_FRAMES;\n          } else {\n            sim.states.forEach(function (state) {\n              state.vanishing_frame = s.CUSTOM_ANIMATION_PERIOD_COUNT * animation_period_frames(sim) + 1;\n              state.start_delay = 0;\n              state_step(sim, state);\n              state.current = state.target.map(copy_pos);\n              state.ages = state.current.map(function () { return max_tetrimino_age(sim); });\n            });\n          }\n          sim.animating = is_animating(sim);\n        } else {\n          var from = new Date(to.getTime() - 60 * 1000);\n          tick(sim, from, true, true);\n          settle(sim);\n          tick(sim, to, false, from.getDate() != to.getDate());\n        }\n        while (sim.animating) {\n          process_animation(sim);\n        }\n        if (!sim.frames.length) {\n          sim.frames.push(render_frame(sim));\n        }\n        return sim;\n      }\n\n      function paint(canvas, sim, cells) {\n        var field = sim.field;\n        var platform = field.platform;\n        var ctx = canvas.getContext(\"2d\");\n        ctx.fillStyle = sim.bg_color;\n        ctx.fillRect(0, 0, platform.width, platform.height);\n        for (var j = 0; j < field.height; ++j) {\n          for (var i = field.row_begin[j]; i < field.row_end[j]; ++i) {\n            var color = cells[j * field.width + i];\n            if (color != sim.bg_color) {\n              ctx.fillStyle = color;\n              ctx.fillRect(platform.offset_x + i * field.pitch, platform.offset_y + j * field.pitch, C.CELL_SIZE, C.CELL_SIZE);\n            }\n          }\n        }\n      }\n\n      // what the transition costs on the watch: the tick wakes it for the\n      // first frame and every further frame is a timer. While the colon\n      // blinks or the seconds are shown, frames near a second boundary are\n      // moved onto it and only the other boundaries wake it once more\n      // (wake.h)\n      function describe(sim, transition) {\n        var s = sim.settings;\n        var frames = sim.frames.length;\n        var period = s.CUSTOM_ANIMATION_TIMEOUT_MS;\n        var duration_ms = (frames - 1) * period;\n        var seconds = (s.ANIMATE_SECOND_DOT || s.SHOW_SECONDS) && !s.SECOND_DOT_WINDOW;\n        var tolerance = Math.min(C.WAKE_ALIGN_MS, Math.floor(period / 2));\n        var unaligned = Math.max(0, 1 - 2 * tolerance / period);\n        var second_wakeups = seconds ? Math.round(Math.floor(duration_ms / 1000) * unaligned) : 0;\n        var wakeups = (transition == \"appear\" ? 0 : 1) + (frames - 1) + second_wakeups;\n\n        var peak_cells = 0;\n        for (var f = 1; f < frames; ++f) {\n          var cells = 0;\n          for (var c = 0; c < sim.frames[f].length; ++c) {\n            cells += sim.frames[f][c] != sim.frames[f - 1][c];\n          }\n          peak_cells = Math.max(peak_cells, cells);\n        }\n        return frames + \" frames in \" + (duration_ms / 1000).toFixed(1) + \" s, about \" + wakeups +\n          \" wakeups (\" + (frames - 1) + \" frames, \" + second_wakeups + \" for seconds alone), up to \" +\n          peak_cells + \" cells repainted per frame\";\n      }\n\n      function preview_restart() {\n        if (s_preview_timer) {\n          clearTimeout(s_preview_timer);\n          s_preview_timer = null;\n        }\n        var platform = PREVIEW_PLATFORMS[document.getElementById(\"preview_platform\").value];\n        var transition = document.getElementById(\"preview_transition\").value;\n        var clock24 = document.getElementById(\"preview_clock\").value == \"24\";\n        var sim = simulate(preview_settings(read_options()), platform, clock24, transition);\n\n        var canvas = document.getElementById(\"preview_canvas\");\n        canvas.width = platform.width;\n        canvas.height = platform.height;\n        canvas.style.width = (platform.width * 2) + \"px\";\n        canvas.className = platform.round ? \"round\" : \"\";\n        document.getElementById(\"preview_stats\").textContent = describe(sim, transition);\n\n        // replays the frames at the animation timeout, then starts over\n        // with a new random drop\n        var frame = 0;\n        var play = function () {\n          paint(canvas, sim, sim.frames[frame]);\n          frame += 1;\n          if (frame < sim.frames.length) {\n            s_preview_timer = setTimeout(play, sim.settings.CUSTOM_ANIMATION_TIMEOUT_MS);\n          } else {\n            s_preview_timer = setTimeout(preview_restart, PREVIEW_PAUSE_MS);\n          }\n        };\n        play();\n      }\n\n      function preview_start() {\n        each(\"input, select\", function (element) {\n          element.addEventListener(\"change\", preview_restart);\n        });\n        preview_restart();\n      }\n    <\/script>\n  <\/head>\n  <body onload=\"parse_options()\">\n    <div style=\"margin:5px\">\n      <h2 style=\"text-align:center\">Configuration<\/h2>\n      <div>\n        <fieldset class=\"preview\">\n          <legend><h3>Preview<\/h3><\/legend>\n          <canvas id=\"preview_canvas\"><\/canvas>\n          <select id=\"preview_platform\">\n            <option value=\"aplite\">Pebble<\/option>\n            <option value=\"basalt\" selected=\"selected\">Pebble Time<\/option>\n            <option value=\"chalk\">Pebble Time Round<\/option>\n          <\/select>\n          <select id=\"preview_clock\">\n            <option value=\"24\">24h clock<\/option>\n            <option value=\"12\">12h clock<\/option>\n          <\/select>\n          <select id=\"preview_transition\">\n            <option value=\"minute\">Next minute<\/option>\n            <option value=\"hour\">12:59 to 13:00<\/option>\n            <option value=\"day\">23:59 to midnight<\/option>\n            <option value=\"appear\">Watchface appearing<\/option>\n          <\/select>\n          <p id=\"preview_stats\"><\/p>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Theme<\/h3><\/legend>\n          <input name=\"LIGHT_THEME\" id=\"LIGHT_THEME_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"LIGHT_THEME_0\">Dark theme<\/label>\n          <input name=\"LIGHT_THEME\" id=\"LIGHT_THEME_1\" value=\"1\" type=\"radio\">\n          <label for=\"LIGHT_THEME_1\">Light theme<\/label>\n        <\/fieldset>\n        <!-- hidden until the compact and sparse layouts in tools/gen_layout.py are tuned on a watch\n        <fieldset>\n          <legend><h3>Digits style<\/h3><\/legend>\n          <input name=\"DIGITS_MODE\" id=\"DIGITS_MODE_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"DIGITS_MODE_0\">Default: asymmetric digits<\/label>\n          <input name=\"DIGITS_MODE\" id=\"DIGITS_MODE_1\" value=\"1\" type=\"radio\">\n          <label for=\"DIGITS_MODE_1\">Compact digits<\/label>\n          <input name=\"DIGITS_MODE\" id=\"DIGITS_MODE_2\" value=\"2\" type=\"radio\">\n          <label for=\"DIGITS_MODE_2\">Sparse digits<\/label>\n        <\/fieldset>\n        -->\n        <fieldset>\n          <legend><h3>Animation settings<\/h3><\/legend>\n          <input id=\"ANIMATE_SECOND_DOT\" type=\"checkbox\" checked=\"checked\">\n          <label for=\"ANIMATE_SECOND_DOT\">Animate seconds colon<\/label>\n          <input id=\"SHOW_SECONDS\" type=\"checkbox\">\n          <label for=\"SHOW_SECONDS\">Show seconds<\/label>\n          <input id=\"SKIP_INITIAL_ANIMATION\" type=\"checkbox\">\n          <label for=\"SKIP_INITIAL_ANIMATION\">Skip initial animation<\/label>\n          <input id=\"LARGE_DATE_FONT\" type=\"checkbox\">\n          <label for=\"LARGE_DATE_FONT\">Use large font for date<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Seconds colon and seconds update<\/h3><\/legend>\n          <input name=\"SECOND_DOT_WINDOW\" id=\"SECOND_DOT_WINDOW_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"SECOND_DOT_WINDOW_0\">Always<\/label>\n          <input name=\"SECOND_DOT_WINDOW\" id=\"SECOND_DOT_WINDOW_10\" value=\"10\" type=\"radio\">\n          <label for=\"SECOND_DOT_WINDOW_10\">For 10 seconds after a wrist flick<\/label>\n          <input name=\"SECOND_DOT_WINDOW\" id=\"SECOND_DOT_WINDOW_30\" value=\"30\" type=\"radio\">\n          <label for=\"SECOND_DOT_WINDOW_30\">For 30 seconds after a wrist flick<\/label>\n          <input name=\"SECOND_DOT_WINDOW\" id=\"SECOND_DOT_WINDOW_60\" value=\"60\" type=\"radio\">\n          <label for=\"SECOND_DOT_WINDOW_60\">For a minute after a wrist flick<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Quiet hours<\/h3><\/legend>\n          <input id=\"QUIET_HOURS\" type=\"checkbox\" onclick=\"set_visible('quiet_hours', this.checked)\" class=\"advanced_checkbox\">\n          <label for=\"QUIET_HOURS\">Change digits without animation, stop seconds and hourly vibration at night<\/label>\n          <span class=\"quiet_hours\">\n            <label for=\"QUIET_HOURS_START\">From hour:<\/label>\n            <input id=\"QUIET_HOURS_START\" type=\"text\" size=\"2\" value=\"23\">\n            <label for=\"QUIET_HOURS_END\">until hour:<\/label>\n            <input id=\"QUIET_HOURS_END\" type=\"text\" size=\"2\" value=\"7\">\n          <\/span>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Date mode<\/h3><\/legend>\n          <input name=\"DATE_MODE\" id=\"DATE_MODE_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"DATE_MODE_0\">Inverted date<\/label>\n          <input name=\"DATE_MODE\" id=\"DATE_MODE_1\" value=\"1\" type=\"radio\">\n          <label for=\"DATE_MODE_1\">Same color date<\/label>\n          <input name=\"DATE_MODE\" id=\"DATE_MODE_2\" value=\"2\" type=\"radio\">\n          <label for=\"DATE_MODE_2\">No date<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Date first line format<\/h3><\/legend>\n          <input name=\"DATE_MONTH_FORMAT\" id=\"DATE_MONTH_FORMAT_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"DATE_MONTH_FORMAT_0\">Month and date<\/label>\n          <input name=\"DATE_MONTH_FORMAT\" id=\"DATE_MONTH_FORMAT_1\" value=\"1\" type=\"radio\">\n          <label for=\"DATE_MONTH_FORMAT_1\">Date and month<\/label>\n          <input name=\"DATE_MONTH_FORMAT\" id=\"DATE_MONTH_FORMAT_2\" value=\"2\" type=\"radio\">\n          <label for=\"DATE_MONTH_FORMAT_2\">Weekday and date<\/label>\n          <input name=\"DATE_MONTH_FORMAT\" id=\"DATE_MONTH_FORMAT_3\" value=\"3\" type=\"radio\">\n          <label for=\"DATE_MONTH_FORMAT_3\">Date and weekday<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Date second line format<\/h3><\/legend>\n          <input name=\"DATE_WEEKDAY_FORMAT\" id=\"DATE_WEEKDAY_FORMAT_0\" value=\"0\" type=\"radio\">\n          <label for=\"DATE_WEEKDAY_FORMAT_0\">Marked weekday<\/label>\n          <input name=\"DATE_WEEKDAY_FORMAT\" id=\"DATE_WEEKDAY_FORMAT_1\" value=\"1\" type=\"radio\">\n          <label for=\"DATE_WEEKDAY_FORMAT_1\">Initial weekday<\/label>\n          <input name=\"DATE_WEEKDAY_FORMAT\" id=\"DATE_WEEKDAY_FORMAT_2\" value=\"2\" checked=\"checked\" type=\"radio\">\n          <label for=\"DATE_WEEKDAY_FORMAT_2\">Text weekday<\/label>\n          <input name=\"DATE_WEEKDAY_FORMAT\" id=\"DATE_WEEKDAY_FORMAT_3\" value=\"3\" type=\"radio\">\n          <label for=\"DATE_WEEKDAY_FORMAT_3\">Empty<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>First weekday<\/h3><\/legend>\n          <input name=\"DATE_FIRST_WEEKDAY\" id=\"DATE_FIRST_WEEKDAY_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"DATE_FIRST_WEEKDAY_0\">Sunday first<\/label>\n          <input name=\"DATE_FIRST_WEEKDAY\" id=\"DATE_FIRST_WEEKDAY_1\" value=\"1\" type=\"radio\">\n          <label for=\"DATE_FIRST_WEEKDAY_1\">Monday first<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Date language<\/h3><\/legend>\n          <input name=\"DATE_LANGUAGE\" id=\"DATE_LANGUAGE_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"DATE_LANGUAGE_0\">English<\/label>\n          <input name=\"DATE_LANGUAGE\" id=\"DATE_LANGUAGE_1\" value=\"1\" type=\"radio\">\n          <label for=\"DATE_LANGUAGE_1\">Croatian<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Icons<\/h3><\/legend>\n          <input id=\"ICON_CONNECTION\" type=\"checkbox\">\n          <label for=\"ICON_CONNECTION\">Show bluetooth icon when there is no connection<\/label>\n          <input id=\"ICON_BATTERY\" type=\"checkbox\">\n          <label for=\"ICON_BATTERY\">Show battery icon when battery is low or charging<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Disconnection notification vibration<\/h3><\/legend>\n          <input name=\"NOTIFICATION_DISCONNECTED\" id=\"NOTIFICATION_DISCONNECTED_0\" value=\"0\" type=\"radio\">\n          <label for=\"NOTIFICATION_DISCONNECTED_0\">None<\/label>\n          <input name=\"NOTIFICATION_DISCONNECTED\" id=\"NOTIFICATION_DISCONNECTED_1\" value=\"1\" type=\"radio\">\n          <label for=\"NOTIFICATION_DISCONNECTED_1\">Short<\/label>\n          <input name=\"NOTIFICATION_DISCONNECTED\" id=\"NOTIFICATION_DISCONNECTED_2\" value=\"2\" type=\"radio\">\n          <label for=\"NOTIFICATION_DISCONNECTED_2\">Long<\/label>\n          <input name=\"NOTIFICATION_DISCONNECTED\" id=\"NOTIFICATION_DISCONNECTED_3\" value=\"3\" checked=\"checked\" type=\"radio\">\n          <label for=\"NOTIFICATION_DISCONNECTED_3\">Double<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Reconnection notification vibration<\/h3><\/legend>\n          <input name=\"NOTIFICATION_CONNECTED\" id=\"NOTIFICATION_CONNECTED_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"NOTIFICATION_CONNECTED_0\">None<\/label>\n          <input name=\"NOTIFICATION_CONNECTED\" id=\"NOTIFICATION_CONNECTED_1\" value=\"1\" type=\"radio\">\n          <label for=\"NOTIFICATION_CONNECTED_1\">Short<\/label>\n          <input name=\"NOTIFICATION_CONNECTED\" id=\"NOTIFICATION_CONNECTED_2\" value=\"2\" type=\"radio\">\n          <label for=\"NOTIFICATION_CONNECTED_2\">Long<\/label>\n          <input name=\"NOTIFICATION_CONNECTED\" id=\"NOTIFICATION_CONNECTED_3\" value=\"3\" type=\"radio\">\n          <label for=\"NOTIFICATION_CONNECTED_3\">Double<\/label>\n        <\/fieldset>\n        <fieldset id=\"dest\">\n          <legend><h3>Hourly notification vibration<\/h3><\/legend>\n          <input name=\"NOTIFICATION_HOURLY\" id=\"NOTIFICATION_HOURLY_0\" value=\"0\" checked=\"checked\" type=\"radio\">\n          <label for=\"NOTIFICATION_HOURLY_0\">None<\/label>\n          <input name=\"NOTIFICATION_HOURLY\" id=\"NOTIFICATION_HOURLY_1\" value=\"1\" type=\"radio\">\n          <label for=\"NOTIFICATION_HOURLY_1\">Short<\/label>\n          <input name=\"NOTIFICATION_HOURLY\" id=\"NOTIFICATION_HOURLY_2\" value=\"2\" type=\"radio\">\n          <label for=\"NOTIFICATION_HOURLY_2\">Long<\/label>\n          <input name=\"NOTIFICATION_HOURLY\" id=\"NOTIFICATION_HOURLY_3\" value=\"3\" type=\"radio\">\n          <label for=\"NOTIFICATION_HOURLY_3\">Double<\/label>\n        <\/fieldset>\n        <fieldset>\n          <legend><h3>Advanced settings<\/h3><\/legend>\n          <input id=\"CUSTOM_DATE\" type=\"checkbox\" onclick=\"set_visible('custom_date', this.checked)\" class=\"advanced_checkbox\">\n          <label for=\"CUSTOM_DATE\">Custom date offsets<\/label>\n          \n          <input id=\"CUSTOM_ANIMATIONS\" type=\"checkbox\" onclick=\"set_visible('custom_animations', this.checked)\"  class=\"advanced_checkbox\">\n          <label for=\"CUSTOM_ANIMATIONS\">Custom animation settings<\/label>\n\n          <button type=\"button\" id=\"read_log\" onclick=\"read_log()\">Send watch log to phone<\/button>\n        <\/fieldset>\n        <fieldset class=\"custom_date\">\n          <label for=\"CUSTOM_TIME_OFFSET\">Vertical time offset:<\/label>\n          <input id=\"CUSTOM_TIME_OFFSET\" type=\"text\" size=\"1\" value=\"2\">\n          <label for=\"CUSTOM_TIME_DATE_SPACING_1\">Spacing between time and date/time split<\/label>\n          <input id=\"CUSTOM_TIME_DATE_SPACING_1\" type=\"text\" size=\"1\" value=\"2\">\n          <label for=\"CUSTOM_TIME_DATE_SPACING_2\">Spacing between date and date/time split<\/label>\n          <input id=\"CUSTOM_TIME_DATE_SPACING_2\" type=\"text\" size=\"1\" value=\"2\">\n          <label for=\"CUSTOM_DATE_WORD_SPACING\">Date word spacing<\/label>\n          <input id=\"CUSTOM_DATE_WORD_SPACING\" type=\"text\" size=\"1\" value=\"3\">\n          <label for=\"CUSTOM_DATE_LINE_SPACING\">Date line spacing<\/label>\n          <input id=\"CUSTOM_DATE_LINE_SPACING\" type=\"text\" size=\"1\" value=\"2\">\n        <\/fieldset>\n        <fieldset class=\"custom_animations\">\n          <label for=\"CUSTOM_ANIMATION_TIMEOUT_MS\">Animation timeout in ms:<\/label>\n          <input id=\"CUSTOM_ANIMATION_TIMEOUT_MS\" type=\"text\" size=\"4\" value=\"100\">\n          <label for=\"CUSTOM_ANIMATION_PERIOD_VIS_FRAMES\">Vanishing animation inivisble frames:<\/label>\n          <input id=\"CUSTOM_ANIMATION_PERIOD_VIS_FRAMES\" type=\"text\" size=\"2\" value=\"2\">\n          <label for=\"CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES\">Vanishing animation visible frames:<\/label>\n          <input id=\"CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES\" type=\"text\" size=\"2\" value=\"1\">\n          <label for=\"CUSTOM_ANIMATION_PERIOD_COUNT\">Vanishing animation period count:<\/label>\n          <input id=\"CUSTOM_ANIMATION_PERIOD_COUNT\" type=\"text\" size=\"2\" value=\"3\">\n          <label for=\"CUSTOM_ANIMATION_DATE_PERIOD_FRAMES\">Date appearance animation step frames:<\/label>\n          <input id=\"CUSTOM_ANIMATION_DATE_PERIOD_FRAMES\" type=\"text\" size=\"2\" value=\"4\">\n          <label for=\"CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES\">Tetrimino fade step frames:<\/label>\n          <input id=\"CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES\" type=\"text\" size=\"2\" value=\"5\">\n        <\/fieldset>\n      <\/div>\n      \n      <div class=\"controls\">\n        <button type=\"button\" id=\"save\" onclick=\"save()\">Save<\/button>\n        <button type=\"button\" id=\"cancel\" onclick=\"cancel()\">Cancel<\/button>\n      <\/div>\n    <\/div>\n  <\/body>\n<\/html>\n";
+// END generated
+
+// the page is served from here so that opening it needs no network
 Pebble.addEventListener("showConfiguration",
     function(e) {
-         var url = 'http://gogothegogo.github.io/TetrisTime/';
         var options = window.localStorage.getItem("options");
         if (options !== null) {
-            options = escape(options);
             console.log('Showing config with options=' + options);
-            Pebble.openURL(url + '?options=' + options);
         } else {
             console.log('Showing config with no options');
-            Pebble.openURL(url);
+            options = '{}';
         }
+        var page = CONFIG_PAGE.replace('{} /* options */', options);
+        Pebble.openURL('data:text/html;charset=utf-8,' + encodeURIComponent(page));
     }
 );
 
@@ -37,6 +66,11 @@ Pebble.addEventListener("webviewclosed",
     function(e) {
         console.log('Got response: ' + e.response);
         var config = JSON.parse(e.response);
+        // the page asked for the watch log, the answer is printed above
+        if ("LOG_DUMP" in config) {
+            Pebble.sendAppMessage({"LOG_DUMP": 0}, function(e) {}, function(e) {});
+            return;
+        }
         
         window.localStorage.options = JSON.stringify(config);
         Pebble.sendAppMessage(config,
@@ -0,0 +1,103 @@
+// generated by tools/gen_layout.py, do not edit
+
+#define LAYOUT_FIELD_WIDTH 36
+#define LAYOUT_SLOT_COUNT 5
+#define LAYOUT_KEY_COUNT 24
+#define LAYOUT_CLOCK_COUNT 1
+
+// digit values that change spacing: leading digit blank/other/"2" and each "1"
+static inline int layout_key(const int* digit_values) {
+    const int leading = digit_values[0] == DIGIT_COUNT ? 0 : (digit_values[0] == 2 ? 2 : 1);
+    return leading * 8 + (digit_values[1] == 1) * 4 + (digit_values[2] == 1) * 2 + (digit_values[3] == 1);
+}
+
+static const int8_t s_layouts[DIM_MAX][LAYOUT_CLOCK_COUNT][LAYOUT_KEY_COUNT][LAYOUT_SLOT_COUNT] = {
+    [DM_ASYMMETRIC] = {
+        { // 12h and 24h
+            {  0,   5,  17,  25,  11}, // leading blank, narrow 000
+            {  1,   6,  18,  24,  12}, // leading blank, narrow 001
+            {  1,   6,  16,  24,  12}, // leading blank, narrow 010
+            {  2,   7,  17,  23,  13}, // leading blank, narrow 011
+            {  1,   4,  16,  24,  10}, // leading blank, narrow 100
+            {  2,   5,  17,  23,  11}, // leading blank, narrow 101
+            {  2,   5,  15,  23,  11}, // leading blank, narrow 110
+            {  3,   6,  16,  22,  12}, // leading blank, narrow 111
+            {  0,   8,  20,  28,  14}, // leading other, narrow 000
+            {  1,   9,  21,  27,  15}, // leading other, narrow 001
+            {  1,   9,  19,  27,  15}, // leading other, narrow 010
+            {  2,  10,  20,  26,  16}, // leading other, narrow 011
+            {  1,   7,  19,  27,  13}, // leading other, narrow 100
+            {  2,   8,  20,  26,  14}, // leading other, narrow 101
+            {  2,   8,  18,  26,  14}, // leading other, narrow 110
+            {  3,   9,  19,  25,  15}, // leading other, narrow 111
+            {  1,   9,  21,  29,  15}, // leading two, narrow 000
+            {  2,  10,  22,  28,  16}, // leading two, narrow 001
+            {  2,  10,  20,  28,  16}, // leading two, narrow 010
+            {  3,  11,  21,  27,  17}, // leading two, narrow 011
+            {  2,   8,  20,  28,  14}, // leading two, narrow 100
+            {  3,   9,  21,  27,  15}, // leading two, narrow 101
+            {  3,   9,  19,  27,  15}, // leading two, narrow 110
+            {  4,  10,  20,  26,  16}, // leading two, narrow 111
+        },
+    },
+    [DM_DENSE] = {
+        { // 12h and 24h
+            { -2,   6,  16,  24,  11}, // leading blank, narrow 000
+            { -1,   7,  17,  23,  12}, // leading blank, narrow 001
+            { -1,   7,  15,  23,  12}, // leading blank, narrow 010
+            {  0,   8,  16,  22,  13}, // leading blank, narrow 011
+            { -1,   5,  15,  23,  10}, // leading blank, narrow 100
+            {  0,   6,  16,  22,  11}, // leading blank, narrow 101
+            {  0,   6,  14,  22,  11}, // leading blank, narrow 110
+            {  1,   7,  15,  21,  12}, // leading blank, narrow 111
+            {  2,  10,  20,  28,  15}, // leading other, narrow 000
+            {  3,  11,  21,  27,  16}, // leading other, narrow 001
+            {  3,  11,  19,  27,  16}, // leading other, narrow 010
+            {  4,  12,  20,  26,  17}, // leading other, narrow 011
+            {  3,   9,  19,  27,  14}, // leading other, narrow 100
+            {  4,  10,  20,  26,  15}, // leading other, narrow 101
+            {  4,  10,  18,  26,  15}, // leading other, narrow 110
+            {  5,  11,  19,  25,  16}, // leading other, narrow 111
+            {  3,  11,  21,  29,  16}, // leading two, narrow 000
+            {  4,  12,  22,  28,  17}, // leading two, narrow 001
+            {  4,  12,  20,  28,  17}, // leading two, narrow 010
+            {  5,  13,  21,  27,  18}, // leading two, narrow 011
+            {  4,  10,  20,  28,  15}, // leading two, narrow 100
+            {  5,  11,  21,  27,  16}, // leading two, narrow 101
+            {  5,  11,  19,  27,  16}, // leading two, narrow 110
+            {  6,  12,  20,  26,  17}, // leading two, narrow 111
+        },
+    },
+    [DM_SPARSE] = {
+        { // 12h and 24h
+            {  0,   4,  18,  25,  11}, // leading blank, narrow 000
+            {  1,   5,  19,  24,  12}, // leading blank, narrow 001
+            {  1,   5,  17,  24,  12}, // leading blank, narrow 010
+            {  2,   6,  18,  23,  13}, // leading blank, narrow 011
+            {  1,   3,  17,  24,  10}, // leading blank, narrow 100
+            {  2,   4,  18,  23,  11}, // leading blank, narrow 101
+            {  2,   4,  16,  23,  11}, // leading blank, narrow 110
+            {  3,   5,  17,  22,  12}, // leading blank, narrow 111
+            {  0,   7,  21,  28,  14}, // leading other, narrow 000
+            {  1,   8,  22,  27,  15}, // leading other, narrow 001
+            {  1,   8,  20,  27,  15}, // leading other, narrow 010
+            {  2,   9,  21,  26,  16}, // leading other, narrow 011
+            {  1,   6,  20,  27,  13}, // leading other, narrow 100
+            {  2,   7,  21,  26,  14}, // leading other, narrow 101
+            {  2,   7,  19,  26,  14}, // leading other, narrow 110
+            {  3,   8,  20,  25,  15}, // leading other, narrow 111
+            {  1,   8,  22,  29,  15}, // leading two, narrow 000
+            {  2,   9,  23,  28,  16}, // leading two, narrow 001
+            {  2,   9,  21,  28,  16}, // leading two, narrow 010
+            {  3,  10,  22,  27,  17}, // leading two, narrow 011
+            {  2,   7,  21,  28,  14}, // leading two, narrow 100
+            {  3,   8,  22,  27,  15}, // leading two, narrow 101
+            {  3,   8,  20,  27,  15}, // leading two, narrow 110
+            {  4,   9,  21,  26,  16}, // leading two, narrow 111
+        },
+    },
+};
+
+static inline const int8_t* layout_offsets(int mode, bool clock24, int key) {
+    return s_layouts[mode][LAYOUT_CLOCK_COUNT > 1 && clock24][key];
+}
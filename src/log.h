@@ -0,0 +1,103 @@
+// Logging with a compile time level per subsystem. A message above the
+// level of its subsystem is dead code, so it and its format string are
+// dropped from the binary; release builds keep errors only.
+//
+// Messages that pass are recorded in a small RAM ring as subsystem, source
+// line and first argument, without formatting. The settings page has a
+// button that makes the phone ask for the ring with a LOG_DUMP message, and
+// the watch answers with its raw records, so field problems can be read
+// back without streaming logs all the time.
+// Development builds additionally print every message as it happens.
+
+typedef enum {
+    LOG_NONE,
+    LOG_ERROR,
+    LOG_INFO,
+    LOG_DEBUG,
+} LogLevel;
+
+typedef enum {
+    LS_APP,
+    LS_SETTINGS,
+    LS_BITMAP,
+} LogSubsystem;
+
+// levels are set with -D, e.g. -DLOG_LEVEL_SETTINGS=LOG_DEBUG
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_INFO
+#endif
+#ifndef LOG_LEVEL_APP
+#define LOG_LEVEL_APP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SETTINGS
+#define LOG_LEVEL_SETTINGS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_BITMAP
+#define LOG_LEVEL_BITMAP LOG_LEVEL_DEFAULT
+#endif
+
+// print messages as they are logged, not only record them
+#ifndef LOG_LIVE
+#define LOG_LIVE 1
+#endif
+
+#define LOG_RING_SIZE 16
+// not a setting, kept clear of the settings keys
+#define LOG_DUMP_KEY 100
+
+typedef struct {
+    uint32_t time;
+    uint16_t line;
+    uint8_t subsystem;
+    uint8_t level;
+    int32_t value;
+} LogRecord;
+
+static LogRecord s_log_ring[LOG_RING_SIZE];
+static uint8_t s_log_next;
+static bool s_log_wrapped;
+
+// a dump is the records oldest first, in one dictionary entry
+#define LOG_DUMP_MESSAGE_SIZE (1 + 7 + sizeof(s_log_ring))
+
+static void log_record(uint8_t subsystem, uint8_t level, int line, int32_t value) {
+    LogRecord* record = &s_log_ring[s_log_next];
+    record->time = time(NULL);
+    record->line = line;
+    record->subsystem = subsystem;
+    record->level = level;
+    record->value = value;
+    s_log_next = (s_log_next + 1) % LOG_RING_SIZE;
+    s_log_wrapped |= !s_log_next;
+}
+
+#define _LOG_VALUE(format, value, ...) (value)
+#define _LOG_APP_LEVEL(level) ((level) == LOG_ERROR ? APP_LOG_LEVEL_ERROR : \
+                               (level) == LOG_INFO ? APP_LOG_LEVEL_INFO : APP_LOG_LEVEL_DEBUG)
+
+// LOG(SETTINGS, LOG_ERROR, "Failed to open outbox, rc=%d", (int)rc);
+// only the first argument after the format is recorded in the ring
+#define LOG(subsystem, level, ...) do { \
+    if (LOG_LEVEL_##subsystem >= (level)) { \
+        log_record(LS_##subsystem, (level), __LINE__, (int32_t)_LOG_VALUE(__VA_ARGS__, 0)); \
+        if (LOG_LIVE) { \
+            APP_LOG(_LOG_APP_LEVEL(level), __VA_ARGS__); \
+        } \
+    } \
+} while (0)
+
+static void log_dump() {
+    LogRecord records[LOG_RING_SIZE];
+    const int count = s_log_wrapped ? LOG_RING_SIZE : s_log_next;
+    const int oldest = s_log_wrapped ? s_log_next : 0;
+    for (int i = 0; i < count; ++i) {
+        records[i] = s_log_ring[(oldest + i) % LOG_RING_SIZE];
+    }
+
+    DictionaryIterator* it;
+    if (app_message_outbox_begin(&it) != APP_MSG_OK) {
+        return;
+    }
+    dict_write_data(it, LOG_DUMP_KEY, (const uint8_t*)records, count * sizeof(LogRecord));
+    app_message_outbox_send();
+}
@@ -0,0 +1,54 @@
+// Coalesces redraw requests. Handlers only record why the screen is stale;
+// while an animation frame is scheduled the request rides along with it,
+// otherwise the layer is marked dirty once and layer_draw redraws only the
+// regions named by the pending reasons.
+
+typedef enum {
+    RR_DIGITS = 1 << 0,
+    RR_DATE = 1 << 1,
+    RR_ICONS = 1 << 2,
+    RR_DOT = 1 << 3,
+    RR_SECONDS = 1 << 4,
+    RR_SPRITES = 1 << 5,
+    // tetriminos moved, the rest of the scene stayed
+    RR_PIECES = 1 << 6,
+    RR_ALL = RR_DIGITS | RR_DATE | RR_ICONS | RR_DOT | RR_SECONDS | RR_SPRITES | RR_PIECES,
+} RenderReason;
+
+static Layer* s_render_layer;
+static uint8_t s_render_pending;
+static bool s_render_frame_due;
+
+static void render_attach(Layer* layer) {
+    s_render_layer = layer;
+    s_render_pending = RR_ALL;
+}
+
+static void render_request(uint8_t reasons) {
+    const bool idle = !s_render_pending;
+    s_render_pending |= reasons;
+    if (idle && !s_render_frame_due && s_render_layer) {
+        layer_mark_dirty(s_render_layer);
+    }
+}
+
+// an animation frame repaints what it changed and absorbs whatever else is
+// pending
+static void render_frame(uint8_t reasons) {
+    s_render_pending |= reasons;
+    if (s_render_layer) {
+        layer_mark_dirty(s_render_layer);
+    }
+}
+
+static void render_set_frame_due(bool due) {
+    s_render_frame_due = due;
+}
+
+// called from layer_draw; a redraw the system asked for (window appearing,
+// a notification leaving) has nothing queued and repaints everything
+static uint8_t render_take() {
+    const uint8_t reasons = s_render_pending ? s_render_pending : RR_ALL;
+    s_render_pending = 0;
+    return reasons;
+}
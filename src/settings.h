@@ -6,7 +6,7 @@ typedef enum {
     VERSION = 0,
     LIGHT_THEME,
     ANIMATE_SECOND_DOT,
-    _UNUSED0,
+    DIGITS_MODE,
 
     DATE_MODE,
     DATE_MONTH_FORMAT,
@@ -22,7 +22,7 @@ typedef enum {
     SKIP_INITIAL_ANIMATION,
     NOTIFICATION_HOURLY,
 
-    CRO_DATE_FONT,
+    DATE_LANGUAGE,
 
     CUSTOM_DATE,
     CUSTOM_TIME_OFFSET,
@@ -40,8 +40,16 @@ typedef enum {
     CUSTOM_ANIMATION_DATE_PERIOD_FRAMES,
     CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES,
     CUSTOM_ANIMATIONS_MAX,
+
+    SECOND_DOT_WINDOW = CUSTOM_ANIMATIONS_MAX,
+    SHOW_SECONDS,
+
+    // no animations, seconds or hourly vibration from start until end hour
+    QUIET_HOURS,
+    QUIET_HOURS_START,
+    QUIET_HOURS_END,
     
-    MAX_KEY = CUSTOM_ANIMATIONS_MAX,
+    MAX_KEY,
 } SettingsKey;
 
 typedef enum {
@@ -66,6 +74,13 @@ typedef enum {
     DMF_MAX,
 } DateMonthFormat;
 
+// date glyph packs, see date_font.h
+typedef enum {
+    DL_ENGLISH,
+    DL_CROATIAN,
+    DL_MAX,
+} DateLanguage;
+
 typedef enum {
     DWF_MARKED,
     DWF_LETTER,
@@ -84,6 +99,9 @@ typedef enum {
 
 typedef int Settings[MAX_KEY];
 
+// every key as a 4 byte integer, as dict_calc_buffer_size counts it
+#define SETTINGS_MESSAGE_SIZE (1 + MAX_KEY * (7 + 4))
+
 static Settings s_settings;
 
 inline static int settings_get_default(SettingsKey key) {
@@ -98,6 +116,64 @@ inline static int settings_get_default(SettingsKey key) {
         return NTF_DOUBLE_PULSE;
     case NOTIFICATION_DISCONNECTED:
         return NTF_DOUBLE_PULSE;
+    case QUIET_HOURS_START:
+        return 23;
+    case QUIET_HOURS_END:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+// parts of the watchface a setting affects, a change reinitialises only those
+typedef enum {
+    SC_LAYOUT = 1 << 0, // digit positions
+    SC_COLORS = 1 << 1, // palette, repaints the whole screen
+    SC_DATE = 1 << 2,
+    SC_SECONDS = 1 << 3, // colon blinking and seconds readout
+    SC_SERVICES = 1 << 4, // bluetooth and battery subscriptions
+    SC_ICONS = 1 << 5,
+    SC_ANIMATION = 1 << 6,
+    SC_QUIET = 1 << 7,
+    SC_ALL = SC_LAYOUT | SC_COLORS | SC_DATE | SC_SECONDS | SC_SERVICES | SC_ICONS | SC_ANIMATION | SC_QUIET,
+} SettingsChange;
+
+// settings that are only read when they are used, like the hourly
+// notification, affect nothing
+inline static uint8_t settings_get_subsystems(SettingsKey key) {
+    switch (key) {
+    case DIGITS_MODE:
+    case CUSTOM_TIME_OFFSET:
+        return SC_LAYOUT;
+    case DATE_MODE:
+        return SC_LAYOUT | SC_DATE;
+    case LIGHT_THEME:
+        return SC_COLORS;
+    case DATE_MONTH_FORMAT:
+    case DATE_WEEKDAY_FORMAT:
+    case DATE_FIRST_WEEKDAY:
+    case DATE_LANGUAGE:
+    case CUSTOM_TIME_DATE_SPACING_1:
+    case CUSTOM_TIME_DATE_SPACING_2:
+    case CUSTOM_DATE_WORD_SPACING:
+    case CUSTOM_DATE_LINE_SPACING:
+        return SC_DATE;
+    case ANIMATE_SECOND_DOT:
+    case SHOW_SECONDS:
+    case SECOND_DOT_WINDOW:
+        return SC_SECONDS;
+    case ICON_CONNECTION:
+    case ICON_BATTERY:
+        return SC_SERVICES | SC_ICONS;
+    case NOTIFICATION_DISCONNECTED:
+    case NOTIFICATION_CONNECTED:
+        return SC_SERVICES;
+    case CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES:
+        return SC_ANIMATION;
+    case QUIET_HOURS:
+    case QUIET_HOURS_START:
+    case QUIET_HOURS_END:
+        return SC_QUIET;
     default:
         return 0;
     }
@@ -106,9 +182,6 @@ inline static int settings_get_default(SettingsKey key) {
 #define MAKE_IN_RANGE(v, min, max) v = (v < min ? min : (v > max ? max : v))
 
 inline static bool settings_is_active(const int* settings, SettingsKey idx) {
-    if (idx == _UNUSED0) {
-        return false;
-    }
     if ((idx > CUSTOM_DATE) && (idx < CUSTOM_DATE_MAX)) {
         return settings[CUSTOM_DATE];
     }
@@ -125,6 +198,7 @@ static bool settings_apply(const int* new_settings) {
     s_settings[VERSION] = SETTINGS_VERSION_VALUE;
     s_settings[LIGHT_THEME] %= 2;
     s_settings[ANIMATE_SECOND_DOT] %= 2;
+    s_settings[DIGITS_MODE] %= DIM_MAX;
     s_settings[DATE_MODE] %= DM_MAX;
     s_settings[DATE_MONTH_FORMAT] %= DMF_MAX;
     s_settings[DATE_WEEKDAY_FORMAT] %= DWF_MAX;
@@ -135,9 +209,14 @@ static bool settings_apply(const int* new_settings) {
     s_settings[NOTIFICATION_CONNECTED] %= NTF_MAX;
     s_settings[SKIP_INITIAL_ANIMATION] %= 2;
     s_settings[NOTIFICATION_HOURLY] %= NTF_MAX;
-    s_settings[CRO_DATE_FONT] %= 2;
+    s_settings[DATE_LANGUAGE] %= DL_MAX;
     s_settings[CUSTOM_DATE] %= 2;
     s_settings[CUSTOM_ANIMATIONS] %= 2;
+    MAKE_IN_RANGE(s_settings[SECOND_DOT_WINDOW], 0, 120);
+    s_settings[SHOW_SECONDS] %= 2;
+    s_settings[QUIET_HOURS] %= 2;
+    MAKE_IN_RANGE(s_settings[QUIET_HOURS_START], 0, 23);
+    MAKE_IN_RANGE(s_settings[QUIET_HOURS_END], 0, 23);
 
     // disable duplicated text weekday
     if (s_settings[DATE_WEEKDAY_FORMAT] == DWF_TEXT) {
@@ -209,8 +288,19 @@ static bool settings_apply(const int* new_settings) {
     return false;
 }
 
+// compares the current settings against older ones, both as applied
+static uint8_t settings_get_changes(const int* old_settings) {
+    uint8_t changes = 0;
+    for (int i = 0; i < MAX_KEY; ++i) {
+        if (s_settings[i] != old_settings[i]) {
+            changes |= settings_get_subsystems(i);
+        }
+    }
+    return changes;
+}
+
 static void settings_save_persistent() {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Saving persistent settings");
+    LOG(SETTINGS, LOG_INFO, "Saving persistent settings");
     for (int i = 0; i < MAX_KEY; ++i) {
         if (settings_is_active(s_settings, i)) {
             persist_write_int(i, s_settings[i]);
@@ -219,30 +309,30 @@ static void settings_save_persistent() {
 }
 
 static void settings_send() {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Sending settings");
+    LOG(SETTINGS, LOG_INFO, "Sending settings");
     DictionaryIterator* it;
     AppMessageResult rc = app_message_outbox_begin(&it);
     if (rc != APP_MSG_OK) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to open outbox, rc=%d", (int)rc);
+        LOG(SETTINGS, LOG_ERROR, "Failed to open outbox, rc=%d", (int)rc);
         return;
     }
 
     for (int i = 0; i < MAX_KEY; ++i) {
         DictionaryResult drc = dict_write_int(it, i, &s_settings[i], 4, 1);
         if (drc != DICT_OK) {
-            APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to write outgoing message, rc=%d", (int)drc);
+            LOG(SETTINGS, LOG_ERROR, "Failed to write outgoing message, rc=%d", (int)drc);
         }
     }
  
     rc = app_message_outbox_send();
     if (rc != APP_MSG_OK) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to send outbox, rc=%d", (int)rc);
+        LOG(SETTINGS, LOG_ERROR, "Failed to send outbox, rc=%d", (int)rc);
         return;
     }
 }
 
 static void settings_load_persistent() {
-    APP_LOG(APP_LOG_LEVEL_INFO, "Reading persistent settings");
+    LOG(SETTINGS, LOG_INFO, "Reading persistent settings");
     Settings new_settings;
     for (int i = 0; i < MAX_KEY; ++i) {
         if (settings_is_active(new_settings, i) && persist_exists(i)) {
@@ -264,11 +354,11 @@ static void settings_read(DictionaryIterator* iter)
     const Tuple* t = dict_read_first(iter);
     
     if (!t) { // startup message
-        APP_LOG(APP_LOG_LEVEL_INFO, "Got options request from js"); 
+        LOG(SETTINGS, LOG_INFO, "Got options request from js"); 
         settings_send();
         return;
     }
-    APP_LOG(APP_LOG_LEVEL_INFO, "Reading js settings"); 
+    LOG(SETTINGS, LOG_INFO, "Reading js settings"); 
     
     Settings new_settings;
     memcpy(&new_settings, &s_settings, sizeof(Settings));
@@ -282,10 +372,10 @@ static void settings_read(DictionaryIterator* iter)
                 //APP_LOG(APP_LOG_LEVEL_INFO, "Read %d=%d", (int)t->key, new_settings[t->key]);
                 break;
             default:
-                APP_LOG(APP_LOG_LEVEL_ERROR, "Unexpected key type: %d:%d", (int)t->key, (int)t->type);
+                LOG(SETTINGS, LOG_ERROR, "Unexpected key type: %d:%d", (int)t->key, (int)t->type);
             }
         } else {
-            APP_LOG(APP_LOG_LEVEL_ERROR, "Unexpected key: %d", (int)t->key);
+            LOG(SETTINGS, LOG_ERROR, "Unexpected key: %d", (int)t->key);
         }
         t = dict_read_next(iter);
     }
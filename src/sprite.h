@@ -0,0 +1,60 @@
+// Looping status icons. The frames of an icon sit side by side in one
+// bitmap strip and are advanced by a slow timer of their own, so an icon
+// moving doesn't wake the digit animation; each step asks only for the
+// sprites to be repainted.
+
+typedef struct {
+    const Bitmap* strip;
+    uint8_t frame_width;
+    uint8_t frame_count;
+    uint16_t frame_ms;
+} SpriteDef;
+
+typedef struct {
+    const SpriteDef* def;
+    uint8_t frame;
+    AppTimer* timer;
+} Sprite;
+
+static void sprite_init(Sprite* sprite, const SpriteDef* def) {
+    sprite->def = def;
+    sprite->frame = def->frame_count - 1;
+    sprite->timer = NULL;
+}
+
+static void draw_sprite(const Sprite* sprite, int x, int y, FieldColor color) {
+    const Bitmap* strip = sprite->def->strip;
+    const int frame_width = sprite->def->frame_width;
+    const char* data = strip->data + sprite->frame * frame_width;
+    for (int j = 0; j < strip->height; ++j) {
+        for (int i = 0; i < frame_width; ++i) {
+            if (data[i] != ' ') {
+                field_draw(x+i, y+j, color);
+            }
+        }
+        data += strip->width;
+    }
+}
+
+static void _sprite_timeout(void* data) {
+    Sprite* sprite = data;
+    sprite->frame = (sprite->frame + 1) % sprite->def->frame_count;
+    sprite->timer = app_timer_register(sprite->def->frame_ms, _sprite_timeout, sprite);
+    render_request(RR_SPRITES);
+}
+
+// a stopped sprite rests on its last frame, as it starts out
+static void sprite_set_running(Sprite* sprite, bool running) {
+    if (running == (sprite->timer != NULL)) {
+        return;
+    }
+    if (running) {
+        sprite->frame = 0;
+        sprite->timer = app_timer_register(sprite->def->frame_ms, _sprite_timeout, sprite);
+    } else {
+        app_timer_cancel(sprite->timer);
+        sprite->timer = NULL;
+        sprite->frame = sprite->def->frame_count - 1;
+    }
+    render_request(RR_SPRITES);
+}
@@ -0,0 +1,79 @@
+// Plans the wakeups of a running animation so that frames and seconds share
+// them. While frames run the seconds tick is dropped, and a frame that
+// reaches a new second does the seconds work itself. A frame due within
+// the alignment tolerance of a second boundary is moved onto it, so the
+// colon still changes on time. A boundary further from every frame gets a
+// wakeup of its own, which costs what the tick did.
+//
+// Frames keep their nominal times. A moved frame only shortens one period
+// and lengthens the next, so the animation runs as long as before.
+
+#define WAKE_ALIGN_MS 50
+
+typedef struct {
+    uint32_t timeout_ms;
+    // false when the wakeup is only for a second boundary
+    bool frame;
+} Wake;
+
+// nominal time of the next frame on the wake clock
+static uint32_t s_wake_frame_ms;
+static int8_t s_wake_second = -1;
+
+// milliseconds that only wrap after weeks, for differences; ms is the
+// part within the current second
+static uint32_t wake_now_ms(int* second, uint16_t* ms) {
+    time_t seconds;
+    time_ms(&seconds, ms);
+    *second = seconds % 60;
+    return (uint32_t)seconds * 1000 + *ms;
+}
+
+// the frame running now starts the beat
+static void wake_begin() {
+    int second;
+    uint16_t ms;
+    s_wake_frame_ms = wake_now_ms(&second, &ms);
+    s_wake_second = second;
+}
+
+// the current second when it was not seen by an earlier wakeup, else -1
+static int wake_new_second() {
+    int second;
+    uint16_t ms;
+    wake_now_ms(&second, &ms);
+    if (second == s_wake_second) {
+        return -1;
+    }
+    s_wake_second = second;
+    return second;
+}
+
+// plans the wakeup after the current one, frame_ran tells whether the
+// current one stepped the animation
+static Wake wake_next(uint32_t period_ms, bool frame_ran, bool seconds) {
+    int second;
+    uint16_t ms;
+    const uint32_t now = wake_now_ms(&second, &ms);
+    if (frame_ran) {
+        s_wake_frame_ms += period_ms;
+        // more than a period late, the beat restarts rather than catching up
+        if ((int32_t)(s_wake_frame_ms - now) < 0) {
+            s_wake_frame_ms = now + period_ms;
+        }
+    }
+    const int32_t until_frame = s_wake_frame_ms - now;
+    const uint32_t frame_in = until_frame > 0 ? until_frame : 0;
+    if (!seconds) {
+        return (Wake) { frame_in, true };
+    }
+
+    // moving a frame by up to half a period aligns every boundary
+    const uint32_t tolerance = period_ms / 2 < WAKE_ALIGN_MS ? period_ms / 2 : WAKE_ALIGN_MS;
+    const uint32_t second_in = 1000 - ms;
+    if (second_in > frame_in + tolerance) {
+        // a later frame is nearer to the boundary
+        return (Wake) { frame_in, true };
+    }
+    return (Wake) { second_in, second_in + tolerance >= frame_in };
+}
@@ -0,0 +1,280 @@
+// Animation cost analyzer: runs the watchface on the simulated runtime and
+// reports the peak cost of its animations.
+//
+// Every minute of a day is played for each digits mode, clock style and
+// animation variant, so all layouts the face can show are covered. Each
+// digit value pair is also played on a lone digit, which covers pairs the
+// clock never shows.
+//
+// The random choices of the animation are steered instead of sampled.
+// Every drop order is played; a day plays one order on all digits at once,
+// a lone digit every order of the old and the new value. Tetriminos spawn
+// as far from where they land as they can, with the most rotations left.
+// That bounds the spawn, but digits sharing a day with different orders
+// are not covered, so the peaks are not a proven worst case.
+//
+// The tool fails when a measurement exceeds its budget, which keeps slow
+// digit tables or animation changes from slipping in unnoticed.
+//
+// Usage: analyze [report.txt]
+
+static int analyze_choose(int choice, int count, int target);
+#define ANIMATION_CHOOSE(choice, count, target) analyze_choose(choice, count, target)
+
+#include "watchface.h"
+#include "output.h"
+
+// budgets; raise them only together with the change that needs it
+#define BUDGET_TRANSITION_FRAMES 260
+#define BUDGET_FALLING_TETRIMINOS MAX_FALLING_TETRIMINOS
+#define BUDGET_CHANGED_CELLS 220
+#define BUDGET_PAIR_FRAMES 110
+
+#define VALUE_COUNT (DIGIT_COUNT + 1)
+
+#if defined(PBL_ROUND)
+#define PLATFORM "chalk"
+#elif defined(PBL_COLOR)
+#define PLATFORM "basalt"
+#else
+#define PLATFORM "aplite"
+#endif
+
+typedef struct {
+    const char* name;
+    int custom;
+    int period_count;
+    int age_step_frames;
+} AnimationVariant;
+
+static const AnimationVariant s_variants[] = {
+    { "default", 0, 0, 0 },
+    { "no-blink", 1, 0, 5 },
+    { "slow-fade", 1, 3, 15 },
+};
+
+static const char* s_digits_mode_names[DIM_MAX] = { "asymmetric", "dense", "sparse" };
+
+typedef struct {
+    int frames;
+    int falling;
+    int cells;
+} Cost;
+
+typedef struct {
+    Cost peak;
+    long total_frames;
+    int transitions;
+    char peak_at[3][32];
+} Summary;
+
+// drop order every digit gets
+static int s_order;
+
+static int analyze_choose(int choice, int count, int target) {
+    switch (choice) {
+    case AC_ORDER:
+        return s_order;
+    case AC_SPAWN_X:
+        return target > count - 1 - target ? 0 : count - 1;
+    default:
+        return count - 1;
+    }
+}
+
+static int falling_tetriminos() {
+    int falling = 0;
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        falling += state_falling_tetriminos(&s_states[i]);
+    }
+    return falling;
+}
+
+// plays pending animations to the end, one render per frame
+static Cost settle() {
+    Cost cost = { 0, 0, 0 };
+    host_render();
+    while (host_run_next_timer()) {
+        cost.frames += 1;
+        const int falling = falling_tetriminos();
+        if (falling > cost.falling) {
+            cost.falling = falling;
+        }
+        host_reset_counters();
+        host_render();
+        if ((int)g_host_counters.fill_rects > cost.cells) {
+            cost.cells = g_host_counters.fill_rects;
+        }
+    }
+    return cost;
+}
+
+static void apply_settings(int digits_mode, const AnimationVariant* variant) {
+    Settings settings;
+    for (int i = 0; i < MAX_KEY; ++i) {
+        settings[i] = settings_get_default(i);
+    }
+    settings[DIGITS_MODE] = digits_mode;
+    settings[CUSTOM_ANIMATIONS] = variant->custom;
+    if (variant->custom) {
+        settings[CUSTOM_ANIMATION_TIMEOUT_MS] = 90;
+        settings[CUSTOM_ANIMATION_PERIOD_VIS_FRAMES] = 2;
+        settings[CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES] = 1;
+        settings[CUSTOM_ANIMATION_PERIOD_COUNT] = variant->period_count;
+        settings[CUSTOM_ANIMATION_DATE_PERIOD_FRAMES] = 4;
+        settings[CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES] = variant->age_step_frames;
+    }
+    settings_apply(settings);
+    on_settings_changed(SC_ALL);
+    settle();
+}
+
+static void record(Summary* summary, const Cost* cost, const char* label) {
+    const int values[3] = { cost->frames, cost->falling, cost->cells };
+    int* peaks[3] = { &summary->peak.frames, &summary->peak.falling, &summary->peak.cells };
+    for (int i = 0; i < 3; ++i) {
+        if (values[i] > *peaks[i]) {
+            *peaks[i] = values[i];
+            snprintf(summary->peak_at[i], sizeof(summary->peak_at[i]), "%s", label);
+        }
+    }
+    summary->total_frames += cost->frames;
+    summary->transitions += 1;
+}
+
+// a day of minute ticks, starting at 23:59 on the 9th so that midnight also
+// changes the date width
+static void play_day(Summary* summary) {
+    struct tm tick_time;
+    memset(&tick_time, 0, sizeof(tick_time));
+    tick_time.tm_mday = 9;
+    tick_time.tm_hour = 23;
+    tick_time.tm_min = 59;
+    host_tick(&tick_time, MINUTE_UNIT | HOUR_UNIT | DAY_UNIT);
+    settle();
+
+    for (int minute = 0; minute < 24 * 60; ++minute) {
+        char label[32];
+        snprintf(label, sizeof(label), "%02d:%02d->%02d:%02d", tick_time.tm_hour, tick_time.tm_min, minute / 60, minute % 60);
+
+        TimeUnits units = MINUTE_UNIT;
+        if (minute % 60 == 0) {
+            units |= HOUR_UNIT;
+        }
+        if (minute == 0) {
+            units |= DAY_UNIT;
+            tick_time.tm_mday = 10;
+            tick_time.tm_wday = (tick_time.tm_wday + 1) % 7;
+        }
+        tick_time.tm_hour = minute / 60;
+        tick_time.tm_min = minute % 60;
+        host_tick(&tick_time, units);
+        const Cost cost = settle();
+        record(summary, &cost, label);
+    }
+}
+
+// frames a lone digit needs to go from one value in one order to another
+static int play_pair(int from, int from_order, int to, int to_order) {
+    DigitState state;
+    memset(&state, 0, sizeof(state));
+    state.offset_y = s_states[0].offset_y;
+    state.target_value = -1;
+    state.planned_value = -1;
+
+    int frames = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        state.next_value = pass ? to : from;
+        s_order = pass ? to_order : from_order;
+        frames = 0;
+        while (state.falling || state.next_value != state.target_value) {
+            s_spawn_budget = MAX_FALLING_TETRIMINOS - state_falling_tetriminos(&state);
+            state_step(&state);
+            frames += 1;
+        }
+    }
+    return frames;
+}
+
+static int check(const char* what, int value, int budget) {
+    if (value > budget) {
+        fprintf(stderr, "%s: %s is %d, budget is %d\n", PLATFORM, what, value, budget);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    init();
+    host_start();
+    settle();
+
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&buffer, &size);
+    int failures = 0;
+
+    fprintf(out, "# Peak animation cost on %s over every drop order with the farthest\n", PLATFORM);
+    fprintf(out, "# spawns, generated by tools/analyze.c.\n");
+    fprintf(out, "# frames: animation frames of one minute change, falling: tetriminos\n");
+    fprintf(out, "# in flight at once, cells: cells painted in one frame.\n");
+    fprintf(out, "# Budgets: frames %d, falling %d, cells %d, pair frames %d.\n\n",
+            BUDGET_TRANSITION_FRAMES, BUDGET_FALLING_TETRIMINOS, BUDGET_CHANGED_CELLS, BUDGET_PAIR_FRAMES);
+
+    fprintf(out, "%-10s %-5s %-9s %6s %6s %7s %5s  %s\n", "digits", "clock", "animation", "frames", "avg", "falling", "cells", "peak at (frames, falling, cells)");
+    for (int mode = 0; mode < DIM_MAX; ++mode) {
+        for (int clock24 = 0; clock24 < 2; ++clock24) {
+            for (unsigned int v = 0; v < ARRAY_SIZE(s_variants); ++v) {
+                Summary summary;
+                memset(&summary, 0, sizeof(summary));
+                g_host_clock_24h = clock24;
+                apply_settings(mode, &s_variants[v]);
+                for (s_order = 0; s_order < DIGIT_ORDER_COUNT; ++s_order) {
+                    play_day(&summary);
+                }
+                fprintf(out, "%-10s %-5s %-9s %6d %6.1f %7d %5d  %s, %s, %s\n",
+                        s_digits_mode_names[mode], clock24 ? "24h" : "12h", s_variants[v].name,
+                        summary.peak.frames, (double)summary.total_frames / summary.transitions,
+                        summary.peak.falling, summary.peak.cells,
+                        summary.peak_at[0], summary.peak_at[1], summary.peak_at[2]);
+                failures += check("transition frames", summary.peak.frames, BUDGET_TRANSITION_FRAMES);
+                failures += check("falling tetriminos", summary.peak.falling, BUDGET_FALLING_TETRIMINOS);
+                failures += check("changed cells", summary.peak.cells, BUDGET_CHANGED_CELLS);
+            }
+        }
+    }
+
+    apply_settings(DM_ASYMMETRIC, &s_variants[0]);
+    fprintf(out, "\n# Frames of a lone digit changing value, most over all drop orders of\n");
+    fprintf(out, "# both values; row is the old value, column the new one, 10 is the\n");
+    fprintf(out, "# colon and 11 blank.\n");
+    fprintf(out, "from\\to");
+    for (int to = 0; to < VALUE_COUNT; ++to) {
+        fprintf(out, " %3d", to);
+    }
+    fprintf(out, "\n");
+    for (int from = 0; from < VALUE_COUNT; ++from) {
+        fprintf(out, "%7d", from);
+        for (int to = 0; to < VALUE_COUNT; ++to) {
+            int most = 0;
+            for (int from_order = 0; from_order < DIGIT_ORDER_COUNT; ++from_order) {
+                for (int to_order = 0; to_order < DIGIT_ORDER_COUNT; ++to_order) {
+                    const int frames = play_pair(from, from_order, to, to_order);
+                    most = frames > most ? frames : most;
+                }
+            }
+            fprintf(out, " %3d", most);
+            failures += check("pair frames", most, BUDGET_PAIR_FRAMES);
+        }
+        fprintf(out, "\n");
+    }
+    fclose(out);
+
+    if (argc > 1) {
+        failures += write_if_changed(argv[1], buffer, size);
+    } else {
+        fwrite(buffer, 1, size, stdout);
+    }
+    free(buffer);
+    return failures ? 1 : 0;
+}
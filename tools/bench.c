@@ -0,0 +1,248 @@
+// Microbenchmarks for the inner loops of the watchface, run on the host
+// against the counting graphics stubs of the simulated runtime.
+//
+// Each benchmark repeats one primitive until enough time has passed and
+// reports the time per call together with the graphics calls it made.
+// Output is tab separated with a header row, so runs before and after a
+// change can be compared with any table tool.
+//
+// Usage: bench [filter]  runs the benchmarks whose name contains filter
+
+#include <time.h>
+
+#include "watchface.h"
+
+#define MIN_RUN_NS 200000000LL
+
+typedef void (*BenchFunc)(void);
+
+typedef struct {
+    const char* name;
+    BenchFunc setup;
+    BenchFunc run;
+} Bench;
+
+static volatile int s_sink;
+
+static long long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// draws every nth cell of the field
+static void fill_pattern(int every) {
+    for (int y = 0; y < FIELD_HEIGHT; ++y) {
+        for (int x = 0; x < FIELD_WIDTH; ++x) {
+            if (every && (x + y * FIELD_WIDTH) % every == 0) {
+                field_draw(x, y, s_fg_color);
+            }
+        }
+    }
+}
+
+static void setup_field() {
+    field_reset(s_bg_color);
+    field_flush(NULL, NULL);
+}
+
+static void run_field_draw() {
+    for (int y = 0; y < FIELD_HEIGHT; ++y) {
+        for (int x = 0; x < FIELD_WIDTH; ++x) {
+            field_draw(x, y, s_fg_color);
+        }
+    }
+}
+
+static void run_field_flush_clean() {
+    field_flush(NULL, NULL);
+}
+
+// alternating frames make every run repaint the pattern and then clear it
+static int s_flush_frame;
+
+static void run_flush_pattern(int every) {
+    if (s_flush_frame++ & 1) {
+        fill_pattern(every);
+    }
+    field_flush(NULL, NULL);
+}
+
+static void run_field_flush_sparse() {
+    run_flush_pattern(37);
+}
+
+static void run_field_flush_half() {
+    run_flush_pattern(2);
+}
+
+static void run_field_flush_full() {
+    run_flush_pattern(1);
+}
+
+// seconds sized rect in the middle, visible on every platform
+#define BENCH_RECT FIELD_WIDTH / 2 - 4, FIELD_HEIGHT / 2, 7, 5
+
+static void run_field_flush_rect() {
+    if (s_flush_frame++ & 1) {
+        field_fill_rect(BENCH_RECT, s_fg_color);
+    }
+    field_flush_rect(NULL, NULL, BENCH_RECT);
+}
+
+static void run_draw_tetrimino() {
+    const TetriminoDef* td = get_tetrimino_def('t');
+    draw_mask(&td->rotations[1], 12, 13, tetrimino_color(td, MAX_TETRIMINO_AGE / 2));
+}
+
+static void run_draw_bitmap() {
+    draw_bitmap(&s_date_font.weekdays[3], 10, 30, s_fg_color);
+}
+
+static void run_marked_weekday_line() {
+    DateSlot slots[DATE_SLOT_COUNT];
+    int count = 0;
+    layout_marked_weekday_line(slots, &count, 30, 1);
+    for (int i = 0; i < count; ++i) {
+        draw_bitmap(slots[i].bmp, slots[i].x, slots[i].y, s_fg_color);
+    }
+}
+
+static DigitState s_bench_state;
+
+static void setup_state_step() {
+    memset(&s_bench_state, 0, sizeof(s_bench_state));
+    s_bench_state.offset_y = s_states[0].offset_y;
+    s_bench_state.target_value = -1;
+    s_bench_state.planned_value = -1;
+    srand(1);
+}
+
+// cycles through all digits so that planning, vanishing and falling are
+// all part of the average
+static void run_state_step() {
+    DigitState* state = &s_bench_state;
+    if (!state->falling && state->next_value == state->target_value) {
+        state->next_value = (state->target_value + 1) % DIGIT_COUNT;
+    }
+    s_spawn_budget = MAX_FALLING_TETRIMINOS - state_falling_tetriminos(state);
+    state_step(state);
+}
+
+static Settings s_bench_settings;
+
+static void setup_settings_apply() {
+    for (int i = 0; i < MAX_KEY; ++i) {
+        s_bench_settings[i] = settings_get_default(i);
+    }
+    s_bench_settings[CUSTOM_DATE] = 1;
+    s_bench_settings[CUSTOM_ANIMATIONS] = 1;
+}
+
+static void run_settings_apply() {
+    s_sink += settings_apply(s_bench_settings);
+}
+
+// frames of all four digits changing back and forth, ticked and painted the
+// way the face does it
+static int s_bench_flip;
+
+static void setup_animation_frame() {
+    setup_field();
+    srand(1);
+    s_bench_flip = 0;
+}
+
+static void run_animation_frame() {
+    if (!host_run_next_timer()) {
+        struct tm tick_time;
+        memset(&tick_time, 0, sizeof(tick_time));
+        tick_time.tm_hour = s_bench_flip ? 23 : 10;
+        tick_time.tm_min = s_bench_flip ? 59 : 0;
+        s_bench_flip = !s_bench_flip;
+        host_tick(&tick_time, MINUTE_UNIT);
+    }
+    host_render();
+}
+
+// idle seconds ticks with the readout on and the colon blinking, the
+// screen settled first so only the seconds paths run
+static int s_bench_second;
+
+static void setup_seconds_tick() {
+    while (host_run_next_timer()) {
+        host_render();
+    }
+    s_settings[SHOW_SECONDS] = 1;
+    s_settings[ANIMATE_SECOND_DOT] = 1;
+    s_settings[SECOND_DOT_WINDOW] = 0;
+    on_settings_changed(SC_SECONDS);
+    render_request(RR_ALL);
+    host_render();
+    s_bench_second = 0;
+}
+
+static void run_seconds_tick() {
+    struct tm tick_time;
+    memset(&tick_time, 0, sizeof(tick_time));
+    tick_time.tm_hour = 10;
+    tick_time.tm_sec = s_bench_second;
+    s_bench_second = (s_bench_second + 1) % 60;
+    host_tick(&tick_time, SECOND_UNIT);
+    host_render();
+}
+
+static const Bench s_benches[] = {
+    { "field_draw", setup_field, run_field_draw },
+    { "field_flush_clean", setup_field, run_field_flush_clean },
+    { "field_flush_sparse", setup_field, run_field_flush_sparse },
+    { "field_flush_half", setup_field, run_field_flush_half },
+    { "field_flush_full", setup_field, run_field_flush_full },
+    { "field_flush_rect", setup_field, run_field_flush_rect },
+    { "draw_tetrimino", setup_field, run_draw_tetrimino },
+    { "draw_bitmap", setup_field, run_draw_bitmap },
+    { "marked_weekday_line", setup_field, run_marked_weekday_line },
+    { "state_step", setup_state_step, run_state_step },
+    { "settings_apply", setup_settings_apply, run_settings_apply },
+    { "animation_frame", setup_animation_frame, run_animation_frame },
+    { "seconds_tick", setup_seconds_tick, run_seconds_tick },
+};
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    init();
+    host_start();
+    while (host_run_next_timer()) {
+        host_render();
+    }
+
+    printf("name\tcalls\tns_per_call\tfill_rects_per_call\tfill_colors_per_call\n");
+    for (unsigned int b = 0; b < ARRAY_SIZE(s_benches); ++b) {
+        const Bench* bench = &s_benches[b];
+        if (!strstr(bench->name, filter)) {
+            continue;
+        }
+        bench->setup();
+        s_flush_frame = 0;
+        host_reset_counters();
+
+        long long calls = 0;
+        long long batch = 64;
+        const long long start = now_ns();
+        long long elapsed = 0;
+        while (elapsed < MIN_RUN_NS) {
+            for (long long i = 0; i < batch; ++i) {
+                bench->run();
+            }
+            calls += batch;
+            batch *= 2;
+            elapsed = now_ns() - start;
+        }
+        printf("%s\t%lld\t%.1f\t%.2f\t%.2f\n", bench->name, calls, (double)elapsed / calls,
+               (double)g_host_counters.fill_rects / calls, (double)g_host_counters.fill_colors / calls);
+        // drawing primitives leave cells behind, keep the next run clean
+        setup_field();
+    }
+    return 0;
+}
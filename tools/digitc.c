@@ -0,0 +1,599 @@
+// Digit compiler: turns raw digit art (tools/digits/*.txt) into a digit set
+// resource (resources/digits/*.bin, layout in src/digit_set.h) and a
+// listing of it for review (tools/reports/digits_*.txt).
+//
+// Every tiling of the art into tetriminos is enumerated. A tiling is usable
+// when its tetriminos can be dropped one by one from the top, i.e. the
+// "is below" relation between them is acyclic. Among usable tilings the
+// compiler picks the one with the fewest tetriminos, then the shortest
+// animation, then the shortest total fall distance, and orders it for the
+// shortest animation.
+//
+// For visual variety DIGIT_ORDER_COUNT drop orders are emitted per digit:
+// the optimal one first, then the fastest of a batch of random valid orders.
+//
+// Usage: digitc <digits.txt> [digits.bin [listing.txt]]
+//        without outputs the listing is printed
+
+#include "pebble.h"
+#include "assert.h"
+#include "digit.h"
+#include "output.h"
+
+// must match the spawn logic of state_step
+#define ANIMATION_SPACING_Y (TETRIMINO_MASK_SIZE + 1)
+// fall distances are reported for digits placed at the top of the field
+#define REFERENCE_OFFSET_Y 0
+#define MAX_TILINGS 100000
+#define ORDER_CANDIDATES 256
+
+typedef struct {
+    const char* name;
+    RawDigit raw;
+
+    DigitDef tiling;
+    int8_t cover[DIGIT_HEIGHT][DIGIT_WIDTH];
+    int tilings_seen;
+
+    bool found;
+    DigitDef best;
+    int best_frames;
+    int best_fall;
+
+    uint8_t orders[DIGIT_ORDER_COUNT][DIGIT_MAX_TETRIMINOS];
+    int order_frames[DIGIT_ORDER_COUNT];
+} DigitJob;
+
+static int tetrimino_first_cell(const TetriminoDef* td, int rotation, int* first_x, int* first_y) {
+    const TetriminoMask* tm = &td->rotations[rotation];
+    for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+        for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+            if ((*tm)[mask_y][mask_x]) {
+                *first_x = mask_x;
+                *first_y = mask_y;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// rotations producing the same cells (o, and i/s/z shifted by one row) are
+// skipped, the lowest rotation index wins as it needs the fewest turns
+static bool is_duplicate_rotation(const TetriminoDef* td, int rotation) {
+    int x = 0, y = 0;
+    tetrimino_first_cell(td, rotation, &x, &y);
+    for (int r = 0; r < rotation; ++r) {
+        int rx = 0, ry = 0;
+        tetrimino_first_cell(td, r, &rx, &ry);
+        bool same = true;
+        for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE && same; ++mask_y) {
+            for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE && same; ++mask_x) {
+                const int sx = mask_x - x + rx;
+                const int sy = mask_y - y + ry;
+                const int other = (sx >= 0 && sy >= 0 && sx < TETRIMINO_MASK_SIZE && sy < TETRIMINO_MASK_SIZE) ? td->rotations[r][sy][sx] : 0;
+                same = (td->rotations[rotation][mask_y][mask_x] != 0) == (other != 0);
+            }
+        }
+        if (same) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool cell_matches(char cell, char anchor, char letter) {
+    if (anchor == '#') {
+        return cell == '#';
+    }
+    return cell == anchor && (cell | 0x20) == letter;
+}
+
+static bool place(DigitJob* job, const TetriminoPos* tp, int index) {
+    const TetriminoDef* td = get_tetrimino_def(tp->letter);
+    const TetriminoMask* tm = &td->rotations[tp->rotation];
+    int first_x = 0, first_y = 0;
+    tetrimino_first_cell(td, tp->rotation, &first_x, &first_y);
+    const char anchor = job->raw[tp->y + first_y][tp->x + first_x];
+
+    for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+        for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+            if (!(*tm)[mask_y][mask_x]) {
+                continue;
+            }
+            const int x = tp->x + mask_x;
+            const int y = tp->y + mask_y;
+            if (x < 0 || y < 0 || x >= DIGIT_WIDTH || y >= DIGIT_HEIGHT) {
+                return false;
+            }
+            if (job->cover[y][x] >= 0 || !cell_matches(job->raw[y][x], anchor, tp->letter)) {
+                return false;
+            }
+        }
+    }
+    for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+        for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+            if ((*tm)[mask_y][mask_x]) {
+                job->cover[tp->y + mask_y][tp->x + mask_x] = index;
+            }
+        }
+    }
+    return true;
+}
+
+static void unplace(DigitJob* job, int index) {
+    for (int y = 0; y < DIGIT_HEIGHT; ++y) {
+        for (int x = 0; x < DIGIT_WIDTH; ++x) {
+            if (job->cover[y][x] == index) {
+                job->cover[y][x] = -1;
+            }
+        }
+    }
+}
+
+static int spawn_y(const TetriminoPos* tp) {
+    return -REFERENCE_OFFSET_Y - get_tetrimino_def(tp->letter)->size + 1;
+}
+
+// below[a][b] is set when a must land before b can fall past it
+static void build_below(const int8_t cover[DIGIT_HEIGHT][DIGIT_WIDTH], bool below[DIGIT_MAX_TETRIMINOS][DIGIT_MAX_TETRIMINOS]) {
+    memset(below, 0, sizeof(bool) * DIGIT_MAX_TETRIMINOS * DIGIT_MAX_TETRIMINOS);
+    for (int x = 0; x < DIGIT_WIDTH; ++x) {
+        for (int y = 0; y < DIGIT_HEIGHT; ++y) {
+            const int upper = cover[y][x];
+            if (upper < 0) {
+                continue;
+            }
+            for (int yy = y + 1; yy < DIGIT_HEIGHT; ++yy) {
+                const int lower = cover[yy][x];
+                if (lower >= 0 && lower != upper) {
+                    below[lower][upper] = true;
+                }
+            }
+        }
+    }
+}
+
+// Animation length up to the last landing. Each tetrimino spawns once the
+// previous one fell ANIMATION_SPACING_Y rows past its own spawn row, so
+// spawn times telescope and only the first and last tetrimino matter.
+static int estimate_frames(const DigitDef* def) {
+    if (!def->size) {
+        return 0;
+    }
+    const TetriminoPos* first = &def->tetriminos[0];
+    const TetriminoPos* last = &def->tetriminos[def->size - 1];
+    return (def->size - 1) * ANIMATION_SPACING_Y + last->y - spawn_y(first);
+}
+
+static int total_fall(const DigitDef* def) {
+    int fall = 0;
+    for (int i = 0; i < def->size; ++i) {
+        fall += def->tetriminos[i].y - spawn_y(&def->tetriminos[i]);
+    }
+    return fall;
+}
+
+// Orders the tiling for the shortest animation: the smallest tetrimino
+// that may go first, the highest one that may go last, and everything in
+// between bottom up. Returns false if no drop order exists.
+static bool order_tiling(DigitDef* dst, const DigitDef* src, const int8_t cover[DIGIT_HEIGHT][DIGIT_WIDTH]) {
+    bool below[DIGIT_MAX_TETRIMINOS][DIGIT_MAX_TETRIMINOS];
+    build_below(cover, below);
+
+    int best_first = -1;
+    int best_last = -1;
+    int best_cost = 0;
+    for (int first = 0; first < src->size; ++first) {
+        bool is_source = true;
+        for (int i = 0; i < src->size; ++i) {
+            is_source = is_source && !below[i][first];
+        }
+        if (!is_source) {
+            continue;
+        }
+        for (int last = 0; last < src->size; ++last) {
+            if (last == first && src->size > 1) {
+                continue;
+            }
+            bool is_sink = true;
+            for (int i = 0; i < src->size; ++i) {
+                is_sink = is_sink && !below[last][i];
+            }
+            if (!is_sink) {
+                continue;
+            }
+            const int cost = src->tetriminos[last].y - spawn_y(&src->tetriminos[first]);
+            if (best_first < 0 || cost < best_cost) {
+                best_first = first;
+                best_last = last;
+                best_cost = cost;
+            }
+        }
+    }
+    if (best_first < 0) {
+        return src->size == 0;
+    }
+
+    bool placed[DIGIT_MAX_TETRIMINOS] = { false };
+    dst->size = 0;
+    dst->tetriminos[dst->size++] = src->tetriminos[best_first];
+    placed[best_first] = true;
+    while (dst->size < src->size) {
+        int pick = -1;
+        for (int t = 0; t < src->size; ++t) {
+            if (placed[t] || (t == best_last && dst->size + 1 < src->size)) {
+                continue;
+            }
+            bool ready = true;
+            for (int i = 0; i < src->size; ++i) {
+                ready = ready && (placed[i] || !below[i][t]);
+            }
+            if (ready && (pick < 0 || src->tetriminos[t].y > src->tetriminos[pick].y)) {
+                pick = t;
+            }
+        }
+        if (pick < 0) {
+            return false;
+        }
+        dst->tetriminos[dst->size++] = src->tetriminos[pick];
+        placed[pick] = true;
+    }
+    return true;
+}
+
+static void evaluate_tiling(DigitJob* job) {
+    job->tilings_seen += 1;
+
+    DigitDef ordered;
+    if (!order_tiling(&ordered, &job->tiling, (const int8_t (*)[DIGIT_WIDTH])job->cover)) {
+        return;
+    }
+    const int frames = estimate_frames(&ordered);
+    const int fall = total_fall(&ordered);
+    if (job->found) {
+        if (ordered.size != job->best.size) {
+            if (ordered.size > job->best.size) {
+                return;
+            }
+        } else if (frames != job->best_frames) {
+            if (frames > job->best_frames) {
+                return;
+            }
+        } else if (fall >= job->best_fall) {
+            return;
+        }
+    }
+    job->found = true;
+    job->best = ordered;
+    job->best_frames = frames;
+    job->best_fall = fall;
+}
+
+static void cover_from_def(int8_t cover[DIGIT_HEIGHT][DIGIT_WIDTH], const DigitDef* def) {
+    memset(cover, -1, sizeof(int8_t) * DIGIT_HEIGHT * DIGIT_WIDTH);
+    for (int t = 0; t < def->size; ++t) {
+        const TetriminoPos* tp = &def->tetriminos[t];
+        const TetriminoMask* tm = &get_tetrimino_def(tp->letter)->rotations[tp->rotation];
+        for (int mask_y = 0; mask_y < TETRIMINO_MASK_SIZE; ++mask_y) {
+            for (int mask_x = 0; mask_x < TETRIMINO_MASK_SIZE; ++mask_x) {
+                if ((*tm)[mask_y][mask_x]) {
+                    cover[tp->y + mask_y][tp->x + mask_x] = t;
+                }
+            }
+        }
+    }
+}
+
+static void apply_order(DigitDef* dst, const DigitDef* src, const uint8_t* order) {
+    dst->size = src->size;
+    for (int i = 0; i < src->size; ++i) {
+        dst->tetriminos[i] = src->tetriminos[order[i]];
+    }
+}
+
+// deterministic so that regenerating the table gives the same output
+static uint32_t next_random(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void random_order(uint8_t* order, const DigitDef* def, bool below[DIGIT_MAX_TETRIMINOS][DIGIT_MAX_TETRIMINOS], uint32_t* random) {
+    bool placed[DIGIT_MAX_TETRIMINOS] = { false };
+    for (int n = 0; n < def->size; ++n) {
+        int ready[DIGIT_MAX_TETRIMINOS];
+        int ready_count = 0;
+        for (int t = 0; t < def->size; ++t) {
+            bool is_ready = !placed[t];
+            for (int i = 0; i < def->size && is_ready; ++i) {
+                is_ready = placed[i] || !below[i][t];
+            }
+            if (is_ready) {
+                ready[ready_count++] = t;
+            }
+        }
+        const int t = ready[next_random(random) % ready_count];
+        order[n] = t;
+        placed[t] = true;
+    }
+}
+
+// fills job->orders with the compiled order followed by the fastest
+// distinct random orders, repeating when a digit has too few of them
+static void find_orders(DigitJob* job, int seed) {
+    const DigitDef* def = &job->best;
+    int8_t cover[DIGIT_HEIGHT][DIGIT_WIDTH];
+    bool below[DIGIT_MAX_TETRIMINOS][DIGIT_MAX_TETRIMINOS];
+    cover_from_def(cover, def);
+    build_below((const int8_t (*)[DIGIT_WIDTH])cover, below);
+
+    static uint8_t candidates[ORDER_CANDIDATES + 1][DIGIT_MAX_TETRIMINOS];
+    static int candidate_frames[ORDER_CANDIDATES + 1];
+    int count = 0;
+    for (int i = 0; i < def->size; ++i) {
+        candidates[0][i] = i;
+    }
+    candidate_frames[0] = job->best_frames;
+    count = 1;
+
+    uint32_t random = 0x9e3779b9u + seed;
+    for (int attempt = 0; attempt < ORDER_CANDIDATES; ++attempt) {
+        uint8_t order[DIGIT_MAX_TETRIMINOS];
+        random_order(order, def, below, &random);
+        bool duplicate = false;
+        for (int c = 0; c < count && !duplicate; ++c) {
+            duplicate = memcmp(candidates[c], order, def->size) == 0;
+        }
+        if (duplicate) {
+            continue;
+        }
+        DigitDef ordered;
+        apply_order(&ordered, def, order);
+        const int frames = estimate_frames(&ordered);
+        // insertion sort by frames, the compiled order always stays first
+        int pos = count;
+        while (pos > 1 && candidate_frames[pos - 1] > frames) {
+            memcpy(candidates[pos], candidates[pos - 1], DIGIT_MAX_TETRIMINOS);
+            candidate_frames[pos] = candidate_frames[pos - 1];
+            pos -= 1;
+        }
+        memcpy(candidates[pos], order, DIGIT_MAX_TETRIMINOS);
+        candidate_frames[pos] = frames;
+        count += 1;
+    }
+
+    for (int k = 0; k < DIGIT_ORDER_COUNT; ++k) {
+        memcpy(job->orders[k], candidates[k % count], DIGIT_MAX_TETRIMINOS);
+        job->order_frames[k] = candidate_frames[k % count];
+    }
+}
+
+// exact cover search, always filling the first free cell in row order
+static void search(DigitJob* job) {
+    if (job->tilings_seen >= MAX_TILINGS) {
+        return;
+    }
+
+    int cell_x = -1;
+    int cell_y = -1;
+    for (int y = 0; y < DIGIT_HEIGHT && cell_y < 0; ++y) {
+        for (int x = 0; x < DIGIT_WIDTH; ++x) {
+            if (job->raw[y][x] != ' ' && job->cover[y][x] < 0) {
+                cell_x = x;
+                cell_y = y;
+                break;
+            }
+        }
+    }
+    if (cell_y < 0) {
+        evaluate_tiling(job);
+        return;
+    }
+    if (job->tiling.size >= DIGIT_MAX_TETRIMINOS) {
+        return;
+    }
+
+    for (int t = 0; t < TETRIMINO_COUNT; ++t) {
+        const TetriminoDef* td = &s_tetrimino_defs[t];
+        for (int r = 0; r < 4; ++r) {
+            if (is_duplicate_rotation(td, r)) {
+                continue;
+            }
+            int first_x = 0, first_y = 0;
+            tetrimino_first_cell(td, r, &first_x, &first_y);
+
+            TetriminoPos* tp = &job->tiling.tetriminos[job->tiling.size];
+            tp->letter = td->letter;
+            tp->rotation = r;
+            tp->x = cell_x - first_x;
+            tp->y = cell_y - first_y;
+            if (place(job, tp, job->tiling.size)) {
+                job->tiling.size += 1;
+                search(job);
+                job->tiling.size -= 1;
+                unplace(job, job->tiling.size);
+            }
+        }
+    }
+}
+
+static void log_job(const DigitJob* job) {
+    for (int y = 0; y < DIGIT_HEIGHT; ++y) {
+        fprintf(stderr, "  %.*s\n", DIGIT_WIDTH, job->raw[y]);
+    }
+}
+
+static bool compile_digit(DigitJob* job) {
+    int cells = 0;
+    for (int y = 0; y < DIGIT_HEIGHT; ++y) {
+        for (int x = 0; x < DIGIT_WIDTH; ++x) {
+            job->cover[y][x] = -1;
+            cells += job->raw[y][x] != ' ';
+        }
+    }
+    if (cells % 4) {
+        fprintf(stderr, "digit %s: %d cells can't be covered by tetriminos\n", job->name, cells);
+        log_job(job);
+        return false;
+    }
+
+    job->tiling.size = 0;
+    search(job);
+    if (!job->found) {
+        fprintf(stderr, "digit %s: no tiling that can be dropped (%d tilings tried)\n", job->name, job->tilings_seen);
+        log_job(job);
+        return false;
+    }
+    return true;
+}
+
+static int read_digits(FILE* in, DigitJob* jobs, int max_jobs) {
+    static char names[DIGIT_COUNT][16];
+    char line[256];
+    int count = 0;
+    int row = 0;
+    while (fgets(line, sizeof(line), in)) {
+        size_t len = strcspn(line, "\r\n");
+        line[len] = 0;
+        if (len == 0 || (line[0] == '#' && (len < 2 || line[1] == ' '))) {
+            if (row != 0) {
+                fprintf(stderr, "digit %d: expected %d rows, got %d\n", count, DIGIT_HEIGHT, row);
+                return -1;
+            }
+            continue;
+        }
+        if (len != DIGIT_WIDTH) {
+            fprintf(stderr, "digit %d row %d: expected %d columns: '%s'\n", count, row, DIGIT_WIDTH, line);
+            return -1;
+        }
+        if (count >= max_jobs) {
+            fprintf(stderr, "more than %d digits\n", max_jobs);
+            return -1;
+        }
+        for (int x = 0; x < DIGIT_WIDTH; ++x) {
+            const char c = line[x];
+            if (c != '.' && c != '#' && !get_tetrimino_def(c | 0x20)) {
+                fprintf(stderr, "digit %d row %d: unknown cell '%c'\n", count, row, c);
+                return -1;
+            }
+            jobs[count].raw[row][x] = (c == '.') ? ' ' : c;
+        }
+        row += 1;
+        if (row == DIGIT_HEIGHT) {
+            snprintf(names[count], sizeof(names[count]), "%d", count);
+            jobs[count].name = names[count];
+            count += 1;
+            row = 0;
+        }
+    }
+    return count;
+}
+
+// where the digits come from, as the listing names it
+static char s_input_label[256];
+
+static void format_listing(FILE* out, DigitJob* jobs, int count) {
+    fprintf(out, "# Digit set compiled by tools/digitc.c from %s.\n", s_input_label);
+    fprintf(out, "# Tetriminos are letter, rotation, x, y; orders are indices into them,\n");
+    fprintf(out, "# the first one is the fastest. The blank digit is empty.\n");
+    for (int i = 0; i < count; ++i) {
+        const DigitDef* def = &jobs[i].best;
+        fprintf(out, "\n%s: %d tetriminos, %d frames, fall distance %d\n",
+                i < 10 ? jobs[i].name : "colon", def->size, jobs[i].best_frames, jobs[i].best_fall);
+        for (int t = 0; t < def->size; ++t) {
+            const TetriminoPos* tp = &def->tetriminos[t];
+            fprintf(out, "    %c %d %d %d\n", tp->letter, tp->rotation, tp->x, tp->y);
+        }
+        for (int k = 0; k < DIGIT_ORDER_COUNT; ++k) {
+            fprintf(out, "    order");
+            for (int t = 0; t < def->size; ++t) {
+                fprintf(out, " %d", jobs[i].orders[k][t]);
+            }
+            fprintf(out, ", %d frames\n", jobs[i].order_frames[k]);
+        }
+    }
+}
+
+// the blank digit follows the compiled ones with no tetriminos
+static void format_resource(FILE* out, DigitJob* jobs, int count) {
+    fputc(count + 1, out);
+    fputc(DIGIT_ORDER_COUNT, out);
+    for (int i = 0; i < count; ++i) {
+        fputc(jobs[i].best.size, out);
+    }
+    fputc(0, out);
+    for (int i = 0; i < count; ++i) {
+        for (int t = 0; t < jobs[i].best.size; ++t) {
+            const TetriminoPos* tp = &jobs[i].best.tetriminos[t];
+            fputc(tp->letter, out);
+            fputc(tp->rotation, out);
+            fputc((uint8_t)tp->x, out);
+            fputc((uint8_t)tp->y, out);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        for (int k = 0; k < DIGIT_ORDER_COUNT; ++k) {
+            for (int t = 0; t < jobs[i].best.size; ++t) {
+                fputc(jobs[i].orders[k][t], out);
+            }
+        }
+    }
+}
+
+typedef void (*FormatFunc)(FILE* out, DigitJob* jobs, int count);
+
+static int write_output(const char* path, FormatFunc format, DigitJob* jobs, int count) {
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&buffer, &size);
+    format(out, jobs, count);
+    fclose(out);
+    const int rc = write_if_changed(path, buffer, size);
+    free(buffer);
+    return rc;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <digits.txt> [digits.bin [listing.txt]]\n", argv[0]);
+        return 2;
+    }
+    FILE* in = fopen(argv[1], "r");
+    if (!in) {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+    static DigitJob jobs[DIGIT_COUNT];
+    const int count = read_digits(in, jobs, DIGIT_COUNT);
+    fclose(in);
+    if (count < 0) {
+        return 1;
+    }
+    if (count != DIGIT_COUNT) {
+        fprintf(stderr, "expected %d digits, got %d\n", DIGIT_COUNT, count);
+        return 1;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (!compile_digit(&jobs[i])) {
+            return 1;
+        }
+        find_orders(&jobs[i], i);
+    }
+
+    const char* input = strrchr(argv[1], '/');
+    input = input ? input + 1 : argv[1];
+    snprintf(s_input_label, sizeof(s_input_label), "tools/digits/%s", input);
+
+    if (argc < 3) {
+        format_listing(stdout, jobs, count);
+        return 0;
+    }
+    int rc = write_output(argv[2], format_resource, jobs, count);
+    if (argc > 3) {
+        rc |= write_output(argv[3], format_listing, jobs, count);
+    }
+    return rc;
+}
@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+#
+# Embeds app/configuration.html into src/js/pebble-js-app.js so that the
+# phone app can open the settings page as a data URI, without a network
+# round trip. The page stays the single source, the copy in the JS is the
+# part between the BEGIN and END markers and is rewritten on every build.
+#
+# Usage: python tools/gen_config_page.py [page] [script]
+#
+
+import json
+import os
+import sys
+
+from gen_layout import write_if_changed
+
+BEGIN = '// BEGIN generated from app/configuration.html by tools/gen_config_page.py\n'
+END = '// END generated\n'
+
+
+def generate(page, script):
+    begin = script.index(BEGIN) + len(BEGIN)
+    end = script.index(END, begin)
+    # escaping "</" keeps the string safe should it ever end up in a page
+    literal = json.dumps(page).replace('</', '<\\/')
+    return script[:begin] + 'var CONFIG_PAGE = ' + literal + ';\n' + script[end:]
+
+
+def update(page_path, script_path):
+    with open(page_path) as f:
+        page = f.read()
+    with open(script_path) as f:
+        script = f.read()
+    return write_if_changed(script_path, generate(page, script))
+
+
+if __name__ == '__main__':
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+    page_path = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'app', 'configuration.html')
+    script_path = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, 'src', 'js', 'pebble-js-app.js')
+    update(page_path, script_path)
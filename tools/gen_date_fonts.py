@@ -0,0 +1,78 @@
+#!/usr/bin/env python
+#
+# Packs the date glyphs of each language (tools/dates/*.txt) into the raw
+# resources resources/dates/*.bin, so that the watch keeps only the glyphs
+# of the selected language in RAM. The layout is described in
+# src/date_font.h.
+#
+# Languages are listed in DateLanguage order (date_font.h); add a language
+# there, here, to appinfo.json media and to the settings page.
+#
+# Usage: python tools/gen_date_fonts.py
+#
+
+import os
+
+from gen_layout import write_if_changed
+
+LANGUAGES = ['en', 'hr']
+
+# glyph counts of each section, in the order they are packed
+SECTIONS = [('months', 12), ('marked_weekdays', 9), ('weekdays', 7)]
+
+
+def parse(path):
+    month_raise = 0
+    sections = {}
+    glyphs = None
+    rows = []
+
+    def end_glyph():
+        if rows:
+            if any(len(row) != len(rows[0]) for row in rows):
+                raise ValueError('%s: rows of a glyph differ in width: %s' % (path, rows))
+            glyphs.append(list(rows))
+            del rows[:]
+
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip('\r\n')
+            # glyph rows may start with '#' too, comments have a space after it
+            if not line or line == '#' or line.startswith('# '):
+                end_glyph()
+            elif line.startswith('month_raise '):
+                month_raise = int(line.split()[1])
+            elif line.startswith('['):
+                end_glyph()
+                glyphs = sections.setdefault(line.strip('[]'), [])
+            elif glyphs is not None and not line.strip('#.'):
+                rows.append(line)
+            else:
+                raise ValueError('%s: unexpected line: %r' % (path, line))
+        end_glyph()
+
+    for name, count in SECTIONS:
+        if len(sections.get(name, [])) != count:
+            raise ValueError('%s: expected %d %s, got %d' % (path, count, name, len(sections.get(name, []))))
+    return month_raise, sections
+
+
+def generate(path):
+    month_raise, sections = parse(path)
+    glyphs = [glyph for name, count in SECTIONS for glyph in sections[name]]
+    data = bytearray([month_raise])
+    for glyph in glyphs:
+        data += bytearray([len(glyph[0]), len(glyph)])
+    for glyph in glyphs:
+        data += bytearray(''.join(glyph).replace('.', ' ').encode('ascii'))
+    return bytes(data)
+
+
+def update(root):
+    for language in LANGUAGES:
+        write_if_changed(os.path.join(root, 'resources', 'dates', language + '.bin'),
+                         generate(os.path.join(root, 'tools', 'dates', language + '.txt')))
+
+
+if __name__ == '__main__':
+    update(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+#
+# Generates src/layout.h: x offsets of the five time digits (hours, minutes
+# and the colon) for every digits mode, 12/24h clock and digit combination
+# that affects spacing, so tick_handler needs a single table lookup.
+#
+# Layouts are pure data: add a mode here and in DigitsMode (settings.h).
+#
+# Usage: python tools/gen_layout.py [output]
+#
+
+import os
+import sys
+
+# offsets below are for the 144x168 field, wider fields center the table
+FIELD_WIDTH = 36
+
+# slot order matches s_states: hour tens, hour ones, minute tens, minute ones, colon
+SLOT_COUNT = 5
+
+# "1" is narrow and "2" in the leading position looks better shifted right,
+# each entry moves all slots when its condition holds
+KERNING = [
+    ('hour_ones_is_1',   (+1, -1, -1, -1, -1)),
+    ('minute_tens_is_1', (+1, +1, -1, -1, +1)),
+    ('minute_ones_is_1', (+1, +1, +1, -1, +1)),
+    ('leading_is_2',     (+1, +1, +1, +1, +1)),
+]
+
+# base offsets with blank leading digit and with visible leading digit; a
+# mode without its own 24h entry uses the 12h one, and while no mode has
+# one the table has no clock dimension
+#
+# DM_DENSE and DM_SPARSE are placeholders, not yet tuned on a watch, so the
+# settings page keeps their radio hidden
+LAYOUTS = [
+    ('DM_ASYMMETRIC', {
+        12: {'blank': (0, 5, 17, 25, 11), 'full': (0, 8, 20, 28, 14)},
+    }),
+    ('DM_DENSE', {
+        12: {'blank': (-2, 6, 16, 24, 11), 'full': (2, 10, 20, 28, 15)},
+    }),
+    ('DM_SPARSE', {
+        12: {'blank': (0, 4, 18, 25, 11), 'full': (0, 7, 21, 28, 14)},
+    }),
+]
+
+# leading digit classes, see layout_key() in the generated header
+LEADING = ['blank', 'other', 'two']
+
+
+def layout_offsets(base, leading, narrow):
+    offsets = list(base['blank' if leading == 'blank' else 'full'])
+    conditions = {
+        'hour_ones_is_1': narrow & 4,
+        'minute_tens_is_1': narrow & 2,
+        'minute_ones_is_1': narrow & 1,
+        'leading_is_2': leading == 'two',
+    }
+    for name, delta in KERNING:
+        if conditions[name]:
+            offsets = [o + d for o, d in zip(offsets, delta)]
+    return offsets
+
+
+def generate():
+    clocks = (12, 24) if any(24 in layouts for mode, layouts in LAYOUTS) else (12,)
+    lines = []
+    lines.append('// generated by tools/gen_layout.py, do not edit')
+    lines.append('')
+    lines.append('#define LAYOUT_FIELD_WIDTH %d' % FIELD_WIDTH)
+    lines.append('#define LAYOUT_SLOT_COUNT %d' % SLOT_COUNT)
+    lines.append('#define LAYOUT_KEY_COUNT %d' % (len(LEADING) * 8))
+    lines.append('#define LAYOUT_CLOCK_COUNT %d' % len(clocks))
+    lines.append('')
+    lines.append('// digit values that change spacing: leading digit blank/other/"2" and each "1"')
+    lines.append('static inline int layout_key(const int* digit_values) {')
+    lines.append('    const int leading = digit_values[0] == DIGIT_COUNT ? 0 : (digit_values[0] == 2 ? 2 : 1);')
+    lines.append('    return leading * 8 + (digit_values[1] == 1) * 4 + (digit_values[2] == 1) * 2 + (digit_values[3] == 1);')
+    lines.append('}')
+    lines.append('')
+    lines.append('static const int8_t s_layouts[DIM_MAX][LAYOUT_CLOCK_COUNT][LAYOUT_KEY_COUNT][LAYOUT_SLOT_COUNT] = {')
+    for mode, layouts in LAYOUTS:
+        lines.append('    [%s] = {' % mode)
+        for clock in clocks:
+            lines.append('        { // %s' % ('12h and 24h' if len(clocks) == 1 else '%dh' % clock))
+            for leading in LEADING:
+                for narrow in range(8):
+                    offsets = layout_offsets(layouts.get(clock, layouts[12]), leading, narrow)
+                    lines.append('            {%s}, // leading %s, narrow %d%d%d' % (
+                        ', '.join('%3d' % o for o in offsets), leading,
+                        (narrow >> 2) & 1, (narrow >> 1) & 1, narrow & 1))
+            lines.append('        },')
+        lines.append('    },')
+    lines.append('};')
+    lines.append('')
+    lines.append('static inline const int8_t* layout_offsets(int mode, bool clock24, int key) {')
+    lines.append('    return s_layouts[mode][LAYOUT_CLOCK_COUNT > 1 && clock24][key];')
+    lines.append('}')
+    lines.append('')
+    return '\n'.join(lines)
+
+
+# content is text or, for resources, bytes
+def write_if_changed(path, content):
+    mode = 'b' if isinstance(content, bytes) else ''
+    if os.path.exists(path):
+        with open(path, 'r' + mode) as f:
+            if f.read() == content:
+                return False
+    with open(path, 'w' + mode) as f:
+        f.write(content)
+    return True
+
+
+if __name__ == '__main__':
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'src', 'layout.h')
+    write_if_changed(output, generate())
@@ -0,0 +1,328 @@
+// Simulated Pebble runtime for host tools, see host.h.
+
+#include "host.h"
+
+#define HOST_MAX_TIMERS 8
+
+struct Layer {
+    LayerUpdateProc update_proc;
+    bool dirty;
+};
+
+struct Window {
+    WindowHandlers handlers;
+    Layer root;
+    bool loaded;
+};
+
+struct AppTimer {
+    bool active;
+    uint32_t due_ms;
+    AppTimerCallback callback;
+    void* data;
+};
+
+HostCounters g_host_counters;
+HostFillRectHook g_host_fill_rect_hook;
+
+bool g_host_clock_24h = true;
+bool g_host_bluetooth_connected = true;
+BatteryChargeState g_host_battery = { .charge_percent = 100 };
+
+static uint32_t s_now_ms;
+static AppTimer s_timers[HOST_MAX_TIMERS];
+static Window s_window;
+static Window* s_pushed_window;
+static TickHandler s_tick_handler;
+static TimeUnits s_tick_units;
+static GColor s_fill_color;
+
+void host_reset_counters(void) {
+    memset(&g_host_counters, 0, sizeof(g_host_counters));
+}
+
+uint32_t host_now_ms(void) {
+    return s_now_ms;
+}
+
+static AppTimer* next_timer(void) {
+    AppTimer* next = NULL;
+    for (int i = 0; i < HOST_MAX_TIMERS; ++i) {
+        if (s_timers[i].active && (!next || s_timers[i].due_ms < next->due_ms)) {
+            next = &s_timers[i];
+        }
+    }
+    return next;
+}
+
+bool host_run_next_timer(void) {
+    AppTimer* timer = next_timer();
+    if (!timer) {
+        return false;
+    }
+    s_now_ms = timer->due_ms;
+    timer->active = false;
+    g_host_counters.timers += 1;
+    timer->callback(timer->data);
+    return true;
+}
+
+void host_advance(uint32_t ms) {
+    const uint32_t end_ms = s_now_ms + ms;
+    AppTimer* timer;
+    while ((timer = next_timer()) && timer->due_ms <= end_ms) {
+        host_run_next_timer();
+    }
+    s_now_ms = end_ms;
+}
+
+void host_tick(struct tm* tick_time, TimeUnits units_changed) {
+    if (s_tick_handler && (units_changed & s_tick_units)) {
+        s_tick_handler(tick_time, units_changed);
+    }
+}
+
+bool host_render(void) {
+    Layer* layer = &s_window.root;
+    if (!s_window.loaded || !layer->dirty || !layer->update_proc) {
+        return false;
+    }
+    layer->dirty = false;
+    layer->update_proc(layer, NULL);
+    return true;
+}
+
+void host_start(void) {
+    if (s_pushed_window && !s_pushed_window->loaded) {
+        s_pushed_window->loaded = true;
+        if (s_pushed_window->handlers.load) {
+            s_pushed_window->handlers.load(s_pushed_window);
+        }
+    }
+}
+
+// graphics
+
+GRect layer_get_bounds(const Layer* layer) {
+#ifdef PBL_ROUND
+    return (GRect) { { 0, 0 }, { 180, 180 } };
+#else
+    return (GRect) { { 0, 0 }, { 144, 168 } };
+#endif
+}
+
+void layer_mark_dirty(Layer* layer) {
+    g_host_counters.dirty_marks += 1;
+    layer->dirty = true;
+}
+
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+void graphics_context_set_fill_color(GContext* ctx, GColor color) {
+    g_host_counters.fill_colors += 1;
+    s_fill_color = color;
+}
+
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+    g_host_counters.fill_rects += 1;
+    if (g_host_fill_rect_hook) {
+        g_host_fill_rect_hook(rect, s_fill_color);
+    }
+}
+
+// windows and the event loop
+
+Window* window_create(void) {
+    memset(&s_window, 0, sizeof(s_window));
+    return &s_window;
+}
+
+void window_destroy(Window* window) {
+    if (window->loaded && window->handlers.unload) {
+        window->handlers.unload(window);
+    }
+    window->loaded = false;
+    s_pushed_window = NULL;
+}
+
+Layer* window_get_root_layer(const Window* window) {
+    return (Layer*)&window->root;
+}
+
+void window_set_window_handlers(Window* window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+void window_stack_push(Window* window, bool animated) {
+    s_pushed_window = window;
+}
+
+void app_event_loop(void) {
+    host_start();
+    while (host_run_next_timer()) {
+        host_render();
+    }
+}
+
+// timers and services
+
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data) {
+    for (int i = 0; i < HOST_MAX_TIMERS; ++i) {
+        if (!s_timers[i].active) {
+            s_timers[i] = (AppTimer) { true, s_now_ms + timeout_ms, callback, callback_data };
+            return &s_timers[i];
+        }
+    }
+    fprintf(stderr, "host: out of timers\n");
+    abort();
+}
+
+bool app_timer_reschedule(AppTimer* timer, uint32_t new_timeout_ms) {
+    if (!timer->active) {
+        return false;
+    }
+    timer->due_ms = s_now_ms + new_timeout_ms;
+    return true;
+}
+
+void app_timer_cancel(AppTimer* timer) {
+    timer->active = false;
+}
+
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms) {
+    const uint16_t ms = s_now_ms % 1000;
+    if (tloc) {
+        *tloc = s_now_ms / 1000;
+    }
+    if (out_ms) {
+        *out_ms = ms;
+    }
+    return ms;
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+    // a unit fires whenever it or anything finer changes
+    s_tick_units = 0;
+    for (TimeUnits unit = tick_units; unit <= YEAR_UNIT; unit <<= 1) {
+        s_tick_units |= unit;
+    }
+    s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    s_tick_handler = NULL;
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {}
+void accel_tap_service_unsubscribe(void) {}
+
+bool bluetooth_connection_service_peek(void) {
+    return g_host_bluetooth_connected;
+}
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) {}
+void bluetooth_connection_service_unsubscribe(void) {}
+
+BatteryChargeState battery_state_service_peek(void) {
+    return g_host_battery;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {}
+void battery_state_service_unsubscribe(void) {}
+
+bool clock_is_24h_style(void) {
+    return g_host_clock_24h;
+}
+
+void vibes_short_pulse(void) {}
+void vibes_long_pulse(void) {}
+void vibes_double_pulse(void) {}
+
+// resources are read from the resources directory of the tree
+
+#ifndef HOST_RESOURCES_DIR
+#define HOST_RESOURCES_DIR "resources"
+#endif
+
+static const char* s_resource_files[] = {
+    [RESOURCE_ID_DIGITS_DEFAULT] = HOST_RESOURCES_DIR "/digits/default.bin",
+    [RESOURCE_ID_DATES_EN] = HOST_RESOURCES_DIR "/dates/en.bin",
+    [RESOURCE_ID_DATES_HR] = HOST_RESOURCES_DIR "/dates/hr.bin",
+};
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+    return s_resource_files[resource_id];
+}
+
+size_t resource_size(ResHandle handle) {
+    FILE* f = fopen(handle, "rb");
+    if (!f) {
+        fprintf(stderr, "host: can't open %s\n", handle);
+        abort();
+    }
+    fseek(f, 0, SEEK_END);
+    const size_t size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+size_t resource_load(ResHandle handle, uint8_t* buffer, size_t max_length) {
+    FILE* f = fopen(handle, "rb");
+    if (!f) {
+        fprintf(stderr, "host: can't open %s\n", handle);
+        abort();
+    }
+    const size_t size = fread(buffer, 1, max_length, f);
+    fclose(f);
+    return size;
+}
+
+// storage and messaging, nothing is stored and no phone is connected
+
+bool persist_exists(uint32_t key) {
+    return false;
+}
+
+int32_t persist_read_int(uint32_t key) {
+    return 0;
+}
+
+int persist_write_int(uint32_t key, int32_t value) {
+    return sizeof(value);
+}
+
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback) {}
+
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound) {
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator) {
+    return APP_MSG_SEND_REJECTED;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+    return APP_MSG_SEND_REJECTED;
+}
+
+DictionaryResult dict_write_int(DictionaryIterator* iter, uint32_t key, const void* integer, uint8_t width_bytes, bool is_signed) {
+    return DICT_NOT_ENOUGH_STORAGE;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator* iter, uint32_t key, const uint8_t* data, uint16_t size) {
+    return DICT_NOT_ENOUGH_STORAGE;
+}
+
+Tuple* dict_find(const DictionaryIterator* iter, uint32_t key) {
+    return NULL;
+}
+
+Tuple* dict_read_first(DictionaryIterator* iter) {
+    return NULL;
+}
+
+Tuple* dict_read_next(DictionaryIterator* iter) {
+    return NULL;
+}
@@ -0,0 +1,45 @@
+// Simulated Pebble runtime for host tools. Time only moves when a tool
+// fires a timer or delivers a tick, so runs are fast and reproducible.
+// Graphics calls are counted and can be forwarded to a renderer.
+
+#pragma once
+
+#include "pebble.h"
+
+typedef struct {
+    uint32_t fill_rects;
+    uint32_t fill_colors;
+    uint32_t dirty_marks;
+    uint32_t timers;
+} HostCounters;
+
+typedef void (*HostFillRectHook)(GRect rect, GColor color);
+
+extern HostCounters g_host_counters;
+extern HostFillRectHook g_host_fill_rect_hook;
+
+// what the services report, tools may change them at any time
+extern bool g_host_clock_24h;
+extern bool g_host_bluetooth_connected;
+extern BatteryChargeState g_host_battery;
+
+void host_reset_counters(void);
+
+// virtual milliseconds since start
+uint32_t host_now_ms(void);
+
+// fires the earliest pending timer and advances the clock to it; returns
+// false when nothing is pending
+bool host_run_next_timer(void);
+
+// fires timers due within the next ms milliseconds
+void host_advance(uint32_t ms);
+
+// delivers a tick to the subscribed handler if its unit is included
+void host_tick(struct tm* tick_time, TimeUnits units_changed);
+
+// runs the update proc of the root layer if it was marked dirty
+bool host_render(void);
+
+// loads the window pushed by the app, as the event loop would
+void host_start(void);
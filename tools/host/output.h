@@ -0,0 +1,30 @@
+// Output helpers shared by the host tools.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// rewrites the output only when it changed so that builds stay incremental
+static int write_if_changed(const char* path, const char* content, size_t size) {
+    FILE* f = fopen(path, "rb");
+    if (f) {
+        char* old = malloc(size + 1);
+        const size_t old_size = fread(old, 1, size + 1, f);
+        fclose(f);
+        const int same = (old_size == size) && memcmp(old, content, size) == 0;
+        free(old);
+        if (same) {
+            return 0;
+        }
+    }
+    f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "can't write %s\n", path);
+        return 1;
+    }
+    fwrite(content, 1, size, f);
+    fclose(f);
+    return 0;
+}
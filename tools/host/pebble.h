@@ -0,0 +1,209 @@
+// Minimal stand-in for the Pebble SDK header so that the watchface sources
+// in src/ can be compiled into host tools. Only what those sources use is
+// declared here; host.c implements it on top of a simulated clock.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum {
+    APP_LOG_LEVEL_ERROR = 1,
+    APP_LOG_LEVEL_WARNING = 50,
+    APP_LOG_LEVEL_INFO = 100,
+    APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+#define APP_LOG(level, fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} GPoint;
+
+typedef struct {
+    int16_t w;
+    int16_t h;
+} GSize;
+
+typedef struct {
+    GPoint origin;
+    GSize size;
+} GRect;
+
+typedef enum {
+    GCornerNone = 0,
+} GCornerMask;
+
+#define GColorBlackARGB8 0xC0
+#define GColorWhiteARGB8 0xFF
+#define GColorCyanARGB8 0xCF
+#define GColorBlueMoonARGB8 0xC7
+#define GColorOrangeARGB8 0xF8
+#define GColorLimerickARGB8 0xE8
+#define GColorGreenARGB8 0xCC
+#define GColorPurpleARGB8 0xE2
+#define GColorRedARGB8 0xF0
+
+#ifdef PBL_COLOR
+typedef union {
+    uint8_t argb;
+    struct {
+        uint8_t b:2;
+        uint8_t g:2;
+        uint8_t r:2;
+        uint8_t a:2;
+    };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorBlack ((GColor) { .argb = GColorBlackARGB8 })
+#define GColorWhite ((GColor) { .argb = GColorWhiteARGB8 })
+
+static inline bool gcolor_equal(GColor a, GColor b) {
+    return a.argb == b.argb;
+}
+#else
+typedef uint8_t GColor;
+
+#define GColorBlack ((GColor)GColorBlackARGB8)
+#define GColorWhite ((GColor)GColorWhiteARGB8)
+
+static inline bool gcolor_equal(GColor a, GColor b) {
+    return a == b;
+}
+#endif
+
+typedef struct Layer Layer;
+typedef struct GContext GContext;
+typedef struct Window Window;
+typedef struct AppTimer AppTimer;
+typedef struct DictionaryIterator DictionaryIterator;
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef struct {
+    uint8_t charge_percent;
+    bool is_charging;
+    bool is_plugged;
+} BatteryChargeState;
+
+typedef enum {
+    ACCEL_AXIS_X = 0,
+    ACCEL_AXIS_Y = 1,
+    ACCEL_AXIS_Z = 2,
+} AccelAxisType;
+
+typedef enum {
+    APP_MSG_OK = 0,
+    APP_MSG_SEND_REJECTED = 1 << 3,
+} AppMessageResult;
+
+typedef enum {
+    DICT_OK = 0,
+    DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+} DictionaryResult;
+
+typedef enum {
+    TUPLE_BYTE_ARRAY = 0,
+    TUPLE_CSTRING = 1,
+    TUPLE_UINT = 2,
+    TUPLE_INT = 3,
+} TupleType;
+
+typedef struct {
+    uint32_t key;
+    TupleType type;
+    uint16_t length;
+    union {
+        int8_t int8;
+        int32_t int32;
+        uint8_t data[4];
+    } value[];
+} Tuple;
+
+typedef void (*TickHandler)(struct tm* tick_time, TimeUnits units_changed);
+typedef void (*AppTimerCallback)(void* data);
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+typedef void (*BluetoothConnectionHandler)(bool connected);
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+typedef void (*LayerUpdateProc)(Layer* layer, GContext* ctx);
+typedef void (*WindowHandler)(Window* window);
+typedef void (*AppMessageInboxReceived)(DictionaryIterator* iterator, void* context);
+
+typedef struct {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+// graphics
+GRect layer_get_bounds(const Layer* layer);
+void layer_mark_dirty(Layer* layer);
+void layer_set_update_proc(Layer* layer, LayerUpdateProc update_proc);
+void graphics_context_set_fill_color(GContext* ctx, GColor color);
+void graphics_fill_rect(GContext* ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+
+// windows and the event loop
+Window* window_create(void);
+void window_destroy(Window* window);
+Layer* window_get_root_layer(const Window* window);
+void window_set_window_handlers(Window* window, WindowHandlers handlers);
+void window_stack_push(Window* window, bool animated);
+void app_event_loop(void);
+
+// timers and services
+AppTimer* app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void* callback_data);
+bool app_timer_reschedule(AppTimer* timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer* timer);
+// on the virtual clock, unlike time()
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+bool bluetooth_connection_service_peek(void);
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler);
+void bluetooth_connection_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+bool clock_is_24h_style(void);
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_double_pulse(void);
+
+// resources, with the ids the SDK would generate from appinfo.json
+typedef const char* ResHandle;
+#define RESOURCE_ID_DIGITS_DEFAULT 1
+#define RESOURCE_ID_DATES_EN 2
+#define RESOURCE_ID_DATES_HR 3
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle handle);
+size_t resource_load(ResHandle handle, uint8_t* buffer, size_t max_length);
+
+// storage and messaging
+bool persist_exists(uint32_t key);
+int32_t persist_read_int(uint32_t key);
+int persist_write_int(uint32_t key, int32_t value);
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound);
+AppMessageResult app_message_outbox_begin(DictionaryIterator** iterator);
+AppMessageResult app_message_outbox_send(void);
+DictionaryResult dict_write_int(DictionaryIterator* iter, uint32_t key, const void* integer, uint8_t width_bytes, bool is_signed);
+DictionaryResult dict_write_data(DictionaryIterator* iter, uint32_t key, const uint8_t* data, uint16_t size);
+Tuple* dict_find(const DictionaryIterator* iter, uint32_t key);
+Tuple* dict_read_first(DictionaryIterator* iter);
+Tuple* dict_read_next(DictionaryIterator* iter);
@@ -0,0 +1,11 @@
+// Pulls the whole watchface into a host tool. Everything in it is static,
+// so including it is what gives tools access to its state and functions;
+// its main is renamed out of the way.
+
+#pragma once
+
+#include "host.h"
+
+#define main watchface_main
+#include "TetrisTime.c"
+#undef main
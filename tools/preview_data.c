@@ -0,0 +1,234 @@
+// Writes the tables the settings page preview renders from into the
+// marked block of app/configuration.html, so the preview draws the same
+// tetriminos, digits, layouts and date glyphs as the watch.
+//
+// The tables are taken from a color build; the page derives the
+// geometry of each platform itself.
+//
+// Usage: preview_data [configuration.html]
+
+#include "watchface.h"
+#include "output.h"
+
+#define BEGIN_MARKER "// BEGIN generated by tools/preview_data.c\n"
+#define END_MARKER "// END generated\n"
+
+#define KEY(key) { #key, key }
+
+static const struct {
+    const char* name;
+    SettingsKey key;
+} s_keys[] = {
+    KEY(LIGHT_THEME), KEY(ANIMATE_SECOND_DOT), KEY(DIGITS_MODE),
+    KEY(DATE_MODE), KEY(DATE_MONTH_FORMAT), KEY(DATE_WEEKDAY_FORMAT), KEY(DATE_FIRST_WEEKDAY),
+    KEY(ICON_CONNECTION), KEY(ICON_BATTERY),
+    KEY(NOTIFICATION_DISCONNECTED), KEY(NOTIFICATION_CONNECTED),
+    KEY(SKIP_INITIAL_ANIMATION), KEY(NOTIFICATION_HOURLY), KEY(DATE_LANGUAGE),
+    KEY(CUSTOM_DATE), KEY(CUSTOM_TIME_OFFSET), KEY(CUSTOM_TIME_DATE_SPACING_1), KEY(CUSTOM_TIME_DATE_SPACING_2),
+    KEY(CUSTOM_DATE_WORD_SPACING), KEY(CUSTOM_DATE_LINE_SPACING),
+    KEY(CUSTOM_ANIMATIONS), KEY(CUSTOM_ANIMATION_TIMEOUT_MS),
+    KEY(CUSTOM_ANIMATION_PERIOD_VIS_FRAMES), KEY(CUSTOM_ANIMATION_PERIOD_INVIS_FRAMES),
+    KEY(CUSTOM_ANIMATION_PERIOD_COUNT), KEY(CUSTOM_ANIMATION_DATE_PERIOD_FRAMES),
+    KEY(CUSTOM_ANIMATION_TETRIMINO_AGE_STEP_FRAMES),
+    KEY(SECOND_DOT_WINDOW), KEY(SHOW_SECONDS),
+    KEY(QUIET_HOURS), KEY(QUIET_HOURS_START), KEY(QUIET_HOURS_END),
+};
+STATIC_ASSERT(ARRAY_SIZE(s_keys) == MAX_KEY - 1);
+
+static void write_constants(FILE* out) {
+    fprintf(out, "  constants: {");
+    fprintf(out, "CELL_SIZE: %d, CELL_SPACING: %d, ", FIELD_CELL_SIZE, FIELD_CELL_SPACING);
+    fprintf(out, "DIGIT_WIDTH: %d, DIGIT_HEIGHT: %d, DIGIT_COUNT: %d, DIGIT_ORDER_COUNT: %d, ",
+            DIGIT_WIDTH, DIGIT_HEIGHT, DIGIT_COUNT, DIGIT_ORDER_COUNT);
+    fprintf(out, "TETRIMINO_MASK_SIZE: %d, STATE_COUNT: %d, ANIMATION_SPACING_Y: %d, ",
+            TETRIMINO_MASK_SIZE, STATE_COUNT, ANIMATION_SPACING_Y);
+    fprintf(out, "MAX_TETRIMINO_AGE_STEPS: %d, TETRIMINO_FADE_STEPS: %d, ", MAX_TETRIMINO_AGE_STEPS, TETRIMINO_FADE_STEPS);
+    fprintf(out, "MAX_FALLING_TETRIMINOS: %d, DIGIT_START_STAGGER_FRAMES: %d, ",
+            MAX_FALLING_TETRIMINOS, DIGIT_START_STAGGER_FRAMES);
+    fprintf(out, "BMP_SMALL_HEIGHT: %d, BMP_SMALL_DIGIT_WIDTH: %d, LAYOUT_FIELD_WIDTH: %d, ",
+            BMP_SMALL_HEIGHT, BMP_SMALL_DIGIT_WIDTH, LAYOUT_FIELD_WIDTH);
+    fprintf(out, "WAKE_ALIGN_MS: %d},\n", WAKE_ALIGN_MS);
+}
+
+static void write_defaults(FILE* out) {
+    fprintf(out, "  defaults: {");
+    for (unsigned int i = 0; i < ARRAY_SIZE(s_keys); ++i) {
+        fprintf(out, "%s%s: %d", i ? ", " : "", s_keys[i].name, settings_get_default(s_keys[i].key));
+    }
+    fprintf(out, "},\n");
+}
+
+// colors as ARGB8 bytes, the page turns them into CSS colors
+static void write_tetriminos(FILE* out) {
+    fprintf(out, "  tetriminos: {\n");
+    for (int t = 0; t < TETRIMINO_COUNT; ++t) {
+        const TetriminoDef* td = &s_tetrimino_defs[t];
+        fprintf(out, "    %c: {size: %d, unique: %d, color: %d, rotations: [",
+                td->letter, td->size, td->unique_shapes, td->color);
+        for (int r = 0; r < 4; ++r) {
+            fprintf(out, "%s\"", r ? ", " : "");
+            for (int y = 0; y < TETRIMINO_MASK_SIZE; ++y) {
+                for (int x = 0; x < TETRIMINO_MASK_SIZE; ++x) {
+                    fputc(td->rotations[r][y][x] ? '#' : ' ', out);
+                }
+            }
+            fprintf(out, "\"");
+        }
+        fprintf(out, "]}%s\n", t + 1 < TETRIMINO_COUNT ? "," : "");
+    }
+    fprintf(out, "  },\n");
+}
+
+static void write_digits(FILE* out) {
+    fprintf(out, "  digits: [\n");
+    for (int d = 0; d <= DIGIT_COUNT; ++d) {
+        const TetriminoPos* tetriminos = digit_tetriminos(d);
+        fprintf(out, "    [");
+        for (int i = 0; i < digit_size(d); ++i) {
+            const TetriminoPos* tp = &tetriminos[i];
+            fprintf(out, "%s[\"%c\", %d, %d, %d]", i ? ", " : "", tp->letter, tp->rotation, tp->x, tp->y);
+        }
+        fprintf(out, "]%s\n", d < DIGIT_COUNT ? "," : "");
+    }
+    fprintf(out, "  ],\n");
+
+    fprintf(out, "  orders: [\n");
+    for (int d = 0; d <= DIGIT_COUNT; ++d) {
+        fprintf(out, "    [");
+        for (int o = 0; o < DIGIT_ORDER_COUNT; ++o) {
+            fprintf(out, "%s[", o ? ", " : "");
+            for (int i = 0; i < digit_size(d); ++i) {
+                fprintf(out, "%s%d", i ? ", " : "", digit_order(d, o)[i]);
+            }
+            fprintf(out, "]");
+        }
+        fprintf(out, "]%s\n", d < DIGIT_COUNT ? "," : "");
+    }
+    fprintf(out, "  ],\n");
+}
+
+static void write_layouts(FILE* out) {
+    fprintf(out, "  layouts: [\n");
+    for (int mode = 0; mode < DIM_MAX; ++mode) {
+        fprintf(out, "    [");
+        for (int clock24 = 0; clock24 < 2; ++clock24) {
+            fprintf(out, "%s[", clock24 ? ", " : "");
+            for (int key = 0; key < LAYOUT_KEY_COUNT; ++key) {
+                fprintf(out, "%s[", key ? ", " : "");
+                for (int slot = 0; slot < LAYOUT_SLOT_COUNT; ++slot) {
+                    fprintf(out, "%s%d", slot ? ", " : "", layout_offsets(mode, clock24, key)[slot]);
+                }
+                fprintf(out, "]");
+            }
+            fprintf(out, "]");
+        }
+        fprintf(out, "]%s\n", mode + 1 < DIM_MAX ? "," : "");
+    }
+    fprintf(out, "  ],\n");
+}
+
+static void write_font(FILE* out, const char* indent, const char* name, const Bitmap* bitmaps, int count, bool last) {
+    fprintf(out, "%s%s: [", indent, name);
+    for (int i = 0; i < count; ++i) {
+        // resource glyphs are not NUL terminated
+        fprintf(out, "%s[%d, %d, \"%.*s\"]", i ? ", " : "", bitmaps[i].width, bitmaps[i].height,
+                bitmaps[i].width * bitmaps[i].height, bitmaps[i].data);
+    }
+    fprintf(out, "]%s\n", last ? "" : ",");
+}
+
+static void write_fonts(FILE* out) {
+    fprintf(out, "  fonts: {\n");
+    write_font(out, "    ", "bmp_small_digits", s_bmp_small_digits, ARRAY_SIZE(s_bmp_small_digits), true);
+    fprintf(out, "  },\n");
+}
+
+// date glyphs of every language pack, indexed by DATE_LANGUAGE
+static void write_languages(FILE* out) {
+    fprintf(out, "  languages: [\n");
+    for (int language = 0; language < DL_MAX; ++language) {
+        date_font_load(language);
+        fprintf(out, "    {\n      month_raise: %d,\n", s_date_font.month_raise);
+        write_font(out, "      ", "months", s_date_font.months, DATE_FONT_MONTHS, false);
+        write_font(out, "      ", "marked_weekdays", s_date_font.marked_weekdays, DATE_FONT_MARKED_WEEKDAYS, false);
+        write_font(out, "      ", "weekdays", s_date_font.weekdays, DATE_FONT_WEEKDAYS, true);
+        fprintf(out, "    }%s\n", language + 1 < DL_MAX ? "," : "");
+    }
+    date_font_unload();
+    fprintf(out, "  ]\n");
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* content = malloc(*size + 1);
+    *size = fread(content, 1, *size, f);
+    content[*size] = '\0';
+    fclose(f);
+    return content;
+}
+
+int main(int argc, char** argv) {
+    digit_set_load(RESOURCE_ID_DIGITS_DEFAULT);
+
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&buffer, &size);
+    fprintf(out, "var PREVIEW_DATA = {\n");
+    write_constants(out);
+    write_defaults(out);
+    write_tetriminos(out);
+    write_digits(out);
+    write_layouts(out);
+    write_fonts(out);
+    write_languages(out);
+    fprintf(out, "};\n");
+    fclose(out);
+
+    if (argc < 2) {
+        fwrite(buffer, 1, size, stdout);
+        free(buffer);
+        return 0;
+    }
+
+    size_t page_size = 0;
+    char* page = read_file(argv[1], &page_size);
+    char* begin = page ? strstr(page, BEGIN_MARKER) : NULL;
+    char* end = begin ? strstr(begin, END_MARKER) : NULL;
+    if (!end) {
+        fprintf(stderr, "%s: no generated block\n", argv[1]);
+        return 1;
+    }
+    begin += strlen(BEGIN_MARKER);
+
+    // the block is indented like the script around it
+    const char* line = begin - strlen(BEGIN_MARKER);
+    while (line > page && line[-1] == ' ') {
+        line -= 1;
+    }
+    const int indent = begin - strlen(BEGIN_MARKER) - line;
+
+    char* result = NULL;
+    size_t result_size = 0;
+    out = open_memstream(&result, &result_size);
+    fwrite(page, 1, begin - page, out);
+    for (const char* c = buffer; *c; ) {
+        const char* eol = strchr(c, '\n');
+        fprintf(out, "%*s%.*s\n", indent, "", (int)(eol - c), c);
+        c = eol + 1;
+    }
+    fprintf(out, "%*s", indent, "");
+    fputs(end, out);
+    fclose(out);
+
+    const int failed = write_if_changed(argv[1], result, result_size);
+    free(result);
+    free(page);
+    free(buffer);
+    return failed;
+}
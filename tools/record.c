@@ -0,0 +1,368 @@
+// Records minute transitions of the watchface into an animated GIF, from
+// the rects the simulated runtime is asked to fill. The screen image is
+// kept across renders like the real framebuffer, so the GIF shows exactly
+// what the delta paths leave on screen.
+//
+// With -heatmap the pixels painted in a frame are coloured by how often
+// they were painted since recording started, blue for once up to white for
+// 128 times and more, and the rest of the screen is dimmed to grey. That
+// shows where a render path repaints cells that did not change. Every
+// frame is also printed as a tab separated row with its graphics calls and
+// painted and changed pixels.
+//
+// The first time is settled before recording starts, each following time
+// is one transition. A store demo can be recorded with
+//   record_basalt -scale 1 app/demo.gif 12:59 13:00 13:01
+//
+// Usage: record [-heatmap] [-scale n] [-pause ms] [-12h] out.gif HH:MM HH:MM...
+
+#include "watchface.h"
+
+#define MAX_FRAMES 4096
+#define HEAT_LEVELS 8
+// palette: the 64 Pebble colors by their RGB bits, then the heat levels
+// and the grey of unpainted pixels
+#define HEAT_INDEX 64
+#define DIM_INDEX (HEAT_INDEX + HEAT_LEVELS)
+
+typedef struct {
+    uint32_t ms;
+    uint8_t* pixels;
+} Frame;
+
+static int s_width;
+static int s_height;
+static uint8_t* s_screen;
+static uint16_t* s_heat;
+static uint8_t* s_painted;
+
+static Frame s_frames[MAX_FRAMES];
+static int s_frame_count;
+static bool s_heatmap;
+
+static const uint8_t s_heat_colors[HEAT_LEVELS][3] = {
+    { 0x00, 0x00, 0xff }, { 0x00, 0x80, 0xff }, { 0x00, 0xff, 0xff }, { 0x00, 0xff, 0x00 },
+    { 0xff, 0xff, 0x00 }, { 0xff, 0x80, 0x00 }, { 0xff, 0x00, 0x00 }, { 0xff, 0xff, 0xff },
+};
+
+static uint8_t color_index(GColor color) {
+#ifdef PBL_COLOR
+    return color.argb & 0x3f;
+#else
+    return color & 0x3f;
+#endif
+}
+
+static void fill_rect_hook(GRect rect, GColor color) {
+    const int x0 = rect.origin.x < 0 ? 0 : rect.origin.x;
+    const int y0 = rect.origin.y < 0 ? 0 : rect.origin.y;
+    const int x1 = rect.origin.x + rect.size.w > s_width ? s_width : rect.origin.x + rect.size.w;
+    const int y1 = rect.origin.y + rect.size.h > s_height ? s_height : rect.origin.y + rect.size.h;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const int i = y * s_width + x;
+            s_screen[i] = color_index(color);
+            s_painted[i] = 1;
+            if (s_heat[i] < UINT16_MAX) {
+                s_heat[i] += 1;
+            }
+        }
+    }
+}
+
+static int heat_level(int count) {
+    int level = 0;
+    while (count > 1 && level + 1 < HEAT_LEVELS) {
+        count >>= 1;
+        level += 1;
+    }
+    return level;
+}
+
+// takes the screen as it is after a render and prints its row
+static void capture() {
+    const int size = s_width * s_height;
+    uint8_t* pixels = malloc(size);
+    int painted = 0;
+    int changed = 0;
+    for (int i = 0; i < size; ++i) {
+        pixels[i] = s_screen[i];
+        if (s_painted[i]) {
+            painted += 1;
+        }
+        if (s_heatmap && s_painted[i]) {
+            pixels[i] = HEAT_INDEX + heat_level(s_heat[i]);
+        } else if (s_heatmap && s_screen[i]) {
+            pixels[i] = DIM_INDEX;
+        }
+        if (s_frame_count && s_frames[s_frame_count - 1].pixels[i] != pixels[i]) {
+            changed += 1;
+        }
+    }
+    memset(s_painted, 0, size);
+
+    if (s_frame_count == MAX_FRAMES) {
+        fprintf(stderr, "record: more than %d frames\n", MAX_FRAMES);
+        exit(1);
+    }
+    s_frames[s_frame_count] = (Frame) { host_now_ms(), pixels };
+    printf("%d\t%u\t%u\t%u\t%d\t%d\n", s_frame_count, s_frames[s_frame_count].ms,
+           g_host_counters.fill_rects, g_host_counters.fill_colors, painted, changed);
+    s_frame_count += 1;
+    host_reset_counters();
+}
+
+// plays pending animations to the end, capturing every render
+static void settle(bool record) {
+    host_reset_counters();
+    if (host_render() && record) {
+        capture();
+    }
+    while (host_run_next_timer()) {
+        if (host_render() && record) {
+            capture();
+        }
+    }
+}
+
+// GIF writing, LZW packed in variable length codes of up to 12 bits
+
+#define LZW_MAX_CODES 4096
+
+typedef struct {
+    FILE* out;
+    uint8_t block[255];
+    int block_size;
+    uint32_t bits;
+    int bit_count;
+} GifWriter;
+
+static uint16_t s_lzw_next[LZW_MAX_CODES][256];
+
+static void write_u16(FILE* out, int value) {
+    fputc(value & 0xff, out);
+    fputc(value >> 8, out);
+}
+
+static void write_code(GifWriter* gif, int code, int code_size) {
+    gif->bits |= code << gif->bit_count;
+    gif->bit_count += code_size;
+    while (gif->bit_count >= 8) {
+        gif->block[gif->block_size++] = gif->bits & 0xff;
+        gif->bits >>= 8;
+        gif->bit_count -= 8;
+        if (gif->block_size == 255) {
+            fputc(255, gif->out);
+            fwrite(gif->block, 1, 255, gif->out);
+            gif->block_size = 0;
+        }
+    }
+}
+
+static void write_image_data(FILE* out, const uint8_t* pixels, int count) {
+    const int clear = 256;
+    const int end = 257;
+    GifWriter gif = { out };
+    int code_size = 9;
+    int next_code = end + 1;
+    memset(s_lzw_next, 0, sizeof(s_lzw_next));
+
+    fputc(8, out);
+    write_code(&gif, clear, code_size);
+    int prefix = pixels[0];
+    for (int i = 1; i < count; ++i) {
+        const int code = s_lzw_next[prefix][pixels[i]];
+        if (code) {
+            prefix = code;
+            continue;
+        }
+        write_code(&gif, prefix, code_size);
+        if (next_code < LZW_MAX_CODES) {
+            s_lzw_next[prefix][pixels[i]] = next_code++;
+            // the decoder adds its entries one code later
+            if (next_code > (1 << code_size) && code_size < 12) {
+                code_size += 1;
+            }
+        } else {
+            write_code(&gif, clear, code_size);
+            memset(s_lzw_next, 0, sizeof(s_lzw_next));
+            code_size = 9;
+            next_code = end + 1;
+        }
+        prefix = pixels[i];
+    }
+    write_code(&gif, prefix, code_size);
+    write_code(&gif, end, code_size);
+    if (gif.bit_count) {
+        write_code(&gif, 0, 8 - gif.bit_count);
+    }
+    if (gif.block_size) {
+        fputc(gif.block_size, out);
+        fwrite(gif.block, 1, gif.block_size, out);
+    }
+    fputc(0, out);
+}
+
+static void write_palette(FILE* out) {
+    for (int i = 0; i < 256; ++i) {
+        uint8_t rgb[3] = { 0, 0, 0 };
+        if (i < HEAT_INDEX) {
+            rgb[0] = ((i >> 4) & 3) * 0x55;
+            rgb[1] = ((i >> 2) & 3) * 0x55;
+            rgb[2] = (i & 3) * 0x55;
+        } else if (i < HEAT_INDEX + HEAT_LEVELS) {
+            memcpy(rgb, s_heat_colors[i - HEAT_INDEX], 3);
+        } else if (i == DIM_INDEX) {
+            memset(rgb, 0x40, 3);
+        }
+        fwrite(rgb, 1, 3, out);
+    }
+}
+
+// bounds of the pixels that differ from the previous frame, false when
+// there are none
+static bool changed_rect(const uint8_t* previous, const uint8_t* pixels, GRect* rect) {
+    int x0 = s_width, y0 = s_height, x1 = -1, y1 = -1;
+    for (int y = 0; y < s_height; ++y) {
+        for (int x = 0; x < s_width; ++x) {
+            if (!previous || previous[y * s_width + x] != pixels[y * s_width + x]) {
+                x0 = x < x0 ? x : x0;
+                y0 = y < y0 ? y : y0;
+                x1 = x > x1 ? x : x1;
+                y1 = y > y1 ? y : y1;
+            }
+        }
+    }
+    *rect = (GRect) { { x0, y0 }, { x1 - x0 + 1, y1 - y0 + 1 } };
+    return x1 >= 0;
+}
+
+// frames that change nothing are merged into the one before, the others
+// are stored as the rect that changed
+static int write_gif(const char* path, int scale, uint32_t pause_ms) {
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        fprintf(stderr, "can't write %s\n", path);
+        return 1;
+    }
+    fwrite("GIF89a", 1, 6, out);
+    write_u16(out, s_width * scale);
+    write_u16(out, s_height * scale);
+    fputc(0xf7, out);
+    fputc(0, out);
+    fputc(0, out);
+    write_palette(out);
+    // loop forever
+    fwrite("\x21\xff\x0bNETSCAPE2.0\x03\x01\x00\x00\x00", 1, 19, out);
+
+    uint8_t* scaled = malloc(s_width * scale * s_height * scale);
+    const uint8_t* previous = NULL;
+    for (int i = 0; i < s_frame_count; ++i) {
+        GRect rect;
+        if (!changed_rect(previous, s_frames[i].pixels, &rect)) {
+            continue;
+        }
+        int next = i + 1;
+        while (next < s_frame_count && !changed_rect(s_frames[i].pixels, s_frames[next].pixels, &(GRect) {})) {
+            next += 1;
+        }
+        // delays are in centiseconds, rounded from the start so they don't drift
+        const uint32_t end_ms = next < s_frame_count ? s_frames[next].ms : s_frames[i].ms + pause_ms;
+        const int delay = (end_ms + 5) / 10 - (s_frames[i].ms + 5) / 10;
+
+        fwrite("\x21\xf9\x04\x04", 1, 4, out);
+        write_u16(out, delay);
+        fwrite("\x00\x00", 1, 2, out);
+
+        const int width = rect.size.w * scale;
+        const int height = rect.size.h * scale;
+        fputc(0x2c, out);
+        write_u16(out, rect.origin.x * scale);
+        write_u16(out, rect.origin.y * scale);
+        write_u16(out, width);
+        write_u16(out, height);
+        fputc(0, out);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                scaled[y * width + x] = s_frames[i].pixels[(rect.origin.y + y / scale) * s_width + rect.origin.x + x / scale];
+            }
+        }
+        write_image_data(out, scaled, width * height);
+        previous = s_frames[i].pixels;
+    }
+    fputc(0x3b, out);
+    fclose(out);
+    free(scaled);
+    return 0;
+}
+
+static bool parse_time(const char* text, struct tm* tick_time) {
+    int hour, minute;
+    if (sscanf(text, "%d:%d", &hour, &minute) != 2 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        fprintf(stderr, "bad time %s, expected HH:MM\n", text);
+        return false;
+    }
+    tick_time->tm_hour = hour;
+    tick_time->tm_min = minute;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int scale = 2;
+    uint32_t pause_ms = 1000;
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+        if (!strcmp(argv[arg], "-heatmap")) {
+            s_heatmap = true;
+        } else if (!strcmp(argv[arg], "-scale") && arg + 1 < argc) {
+            scale = atoi(argv[++arg]);
+        } else if (!strcmp(argv[arg], "-pause") && arg + 1 < argc) {
+            pause_ms = atoi(argv[++arg]);
+        } else if (!strcmp(argv[arg], "-12h")) {
+            g_host_clock_24h = false;
+        } else {
+            break;
+        }
+    }
+    if (argc - arg < 3 || scale < 1) {
+        fprintf(stderr, "usage: %s [-heatmap] [-scale n] [-pause ms] [-12h] out.gif HH:MM HH:MM...\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[arg++];
+
+    init();
+    const GRect bounds = layer_get_bounds(window_get_root_layer(s_window));
+    s_width = bounds.size.w;
+    s_height = bounds.size.h;
+    s_screen = calloc(s_width * s_height, 1);
+    s_heat = calloc(s_width * s_height, sizeof(*s_heat));
+    s_painted = calloc(s_width * s_height, 1);
+    g_host_fill_rect_hook = fill_rect_hook;
+    host_start();
+    settle(false);
+
+    struct tm tick_time;
+    memset(&tick_time, 0, sizeof(tick_time));
+    tick_time.tm_mday = 9;
+    if (!parse_time(argv[arg++], &tick_time)) {
+        return 1;
+    }
+    host_tick(&tick_time, MINUTE_UNIT | HOUR_UNIT | DAY_UNIT);
+    settle(false);
+    memset(s_heat, 0, s_width * s_height * sizeof(*s_heat));
+    memset(s_painted, 0, s_width * s_height);
+
+    printf("frame\tms\tfill_rects\tfill_colors\tpainted\tchanged\n");
+    host_reset_counters();
+    capture();
+    for (; arg < argc; ++arg) {
+        const int hour = tick_time.tm_hour;
+        if (!parse_time(argv[arg], &tick_time)) {
+            return 1;
+        }
+        host_advance(pause_ms);
+        host_tick(&tick_time, MINUTE_UNIT | (hour != tick_time.tm_hour ? HOUR_UNIT : 0));
+        settle(true);
+    }
+    return write_gif(path, scale, pause_ms);
+}